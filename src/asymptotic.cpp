@@ -0,0 +1,179 @@
+#include "asymptotic.h"
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include "pricer.h"
+
+using namespace std;
+constexpr double PI = 3.14159265358979323846;
+
+namespace {
+
+const double INF = numeric_limits<double>::infinity();
+
+// Tolérance absolue sur le prix du repli de Fourier: bien en deçà de l'erreur des
+// développements qu'il remplace.
+constexpr double FOURIER_TOLERANCE = 1e-10;
+
+// Fonction de taux de grande maturité Lambda(p) = lim log E[e^{p X_T}] / T et terme
+// d'ordre 0, L(p), de la fonction génératrice des moments de Heston (log-forward).
+struct LargeTimeCumulant {
+    double v, kappa, theta, sigma, rho;
+
+    double b(double p) const { return kappa - rho * sigma * p; }
+    double d(double p) const { return sqrt(b(p) * b(p) + sigma * sigma * (p - p * p)); }
+    double d1(double p) const {
+        return (-2 * rho * sigma * b(p) + sigma * sigma * (1 - 2 * p)) / (2 * d(p));
+    }
+
+    double lambda(double p) const { return kappa * theta / (sigma * sigma) * (b(p) - d(p)); }
+    double lambda1(double p) const { return kappa * theta / (sigma * sigma) * (-rho * sigma - d1(p)); }
+    double lambda2(double p) const {
+        double d2 = (sigma * sigma * (rho * rho - 1) - d1(p) * d1(p)) / d(p);
+        return -kappa * theta / (sigma * sigma) * d2;
+    }
+    double L(double p) const {
+        double g = (b(p) - d(p)) / (b(p) + d(p));
+        return v * (b(p) - d(p)) / (sigma * sigma) + 2 * kappa * theta / (sigma * sigma) * log(1 - g);
+    }
+};
+
+}  // namespace
+
+HestonAsymptoticPricer::HestonAsymptoticPricer(double S, double v, double kappa, double theta,
+                                               double sigma, double rho, double r)
+    : S(S), v(v), kappa(kappa), theta(theta), sigma(sigma), rho(rho), r(r) {}
+
+double HestonAsymptoticPricer::small_time_vol(double K, double tau, double& error) const {
+    error = INF;
+    double rho_bar = sqrt(1 - rho * rho);
+    if (rho_bar < 1e-8 || v <= 0) {
+        return NAN;
+    }
+    double k = log(K / (S * exp(r * tau)));
+
+    // sigma_0(k)^2 = k^2 / (2 Lambda*(k)), Lambda*(k) = sup_p (p k - Lambda(p)) sur (p-, p+).
+    double sigma0 = sqrt(v);
+    if (fabs(k) > 1e-10) {
+        double y = atan2(rho_bar, rho);
+        double p_plus = 2 * y / (sigma * rho_bar), p_minus = 2 * (y - PI) / (sigma * rho_bar);
+        auto lambda = [&](double p) {
+            if (fabs(p) < 1e-12) {
+                return 0.0;
+            }
+            return v * p / (sigma * (rho_bar / tan(0.5 * sigma * rho_bar * p) - rho));
+        };
+        double a = p_minus * (1 - 1e-9), b = p_plus * (1 - 1e-9);
+        for (int it = 0; it < 100; ++it) {
+            double m1 = a + (b - a) * 0.381966, m2 = a + (b - a) * 0.618034;
+            if (m1 * k - lambda(m1) < m2 * k - lambda(m2)) {
+                a = m1;
+            } else {
+                b = m2;
+            }
+        }
+        double p = 0.5 * (a + b);
+        double rate = p * k - lambda(p);
+        if (!(rate > 0)) {
+            return NAN;
+        }
+        sigma0 = sqrt(k * k / (2 * rate));
+    }
+
+    // Correction d'ordre T de la variance implicite ATM, appliquée à tout le smile.
+    double c = kappa * (theta - v) / 2 + rho * sigma * v / 4 -
+               sigma * sigma * (1 - rho * rho / 4) / 12;
+    double w = sigma0 * sigma0 + c * tau;
+    if (w <= 0) {
+        return NAN;
+    }
+    double vol = sqrt(w);
+    // La correction n'est exacte qu'à la monnaie: l'erreur croît avec la moneyness réduite.
+    error = fabs(vol - sigma0) * (1 + fabs(k) / (sigma0 * sqrt(tau)));
+    return vol;
+}
+
+double HestonAsymptoticPricer::large_time_vol(double K, double tau, double& error) const {
+    error = INF;
+    double rho_bar2 = 1 - rho * rho;
+    if (kappa - rho * sigma <= 0 || rho_bar2 <= 0 || sigma <= 0) {
+        return NAN;
+    }
+    double x = log(K / (S * exp(r * tau))) / tau;
+
+    // Limite SVI: sigma_inf^2(x) = w1/2 (1 + w2 rho x + sqrt((w2 x + rho)^2 + 1 - rho^2)).
+    double A = 2 * kappa - rho * sigma;
+    double w1 = 4 * kappa * theta / (sigma * sigma * rho_bar2) *
+                (sqrt(A * A + sigma * sigma * rho_bar2) - A);
+    double w2 = sigma / (kappa * theta);
+    double w = 0.5 * w1 * (1 + w2 * rho * x + sqrt((w2 * x + rho) * (w2 * x + rho) + rho_bar2));
+
+    // Point-selle Lambda'(p*) = x sur l'intervalle où d(p) est réel.
+    LargeTimeCumulant cum{v, kappa, theta, sigma, rho};
+    double q = sigma * sigma - 2 * kappa * rho * sigma;
+    double disc = sqrt(q * q + 4 * rho_bar2 * sigma * sigma * kappa * kappa);
+    double lo = (q - disc) / (2 * rho_bar2 * sigma * sigma);
+    double hi = (q + disc) / (2 * rho_bar2 * sigma * sigma);
+    lo += 1e-12 * fabs(lo);
+    hi -= 1e-12 * fabs(hi);
+    for (int it = 0; it < 100; ++it) {
+        double m = 0.5 * (lo + hi);
+        if (cum.lambda1(m) > x) {
+            hi = m;
+        } else {
+            lo = m;
+        }
+    }
+    double p = 0.5 * (lo + hi);
+    double p_bs = x / w + 0.5;
+
+    // Correction en 1/T par égalisation des préfacteurs de point-selle Heston et Black-Scholes.
+    double ratio = p * (p - 1) / (p_bs * (p_bs - 1));
+    double curvature = cum.lambda2(p) / w;
+    if (!(ratio > 0) || !(curvature > 0)) {
+        return NAN;
+    }
+    double a1 = 2 * w * w / (x * x - w * w / 4) * (cum.L(p) - log(ratio) - 0.5 * log(curvature));
+    double wc = w + a1 / tau;
+    if (!(wc > 0) || !isfinite(wc)) {
+        return NAN;
+    }
+    double vol = sqrt(wc);
+    // Terme suivant supposé décroître géométriquement (rapport |a1| / (T w)), avec marge 4.
+    double shrink = fabs(a1) / (tau * w);
+    error = 4 * shrink * fabs(vol - sqrt(w));
+    if (!isfinite(error)) {
+        error = INF;
+    }
+    return vol;
+}
+
+AsymptoticQuote HestonAsymptoticPricer::quote_call(double K, double tau) {
+    double small_error, large_error;
+    double small_vol = small_time_vol(K, tau, small_error);
+    double large_vol = large_time_vol(K, tau, large_error);
+
+    if (small_error <= large_error && small_error <= tolerance) {
+        stats.small_time++;
+        return {black_scholes_call(S, K, tau, small_vol, r), small_vol, small_error,
+                AsymptoticRegime::SmallTime};
+    }
+    if (large_error <= tolerance) {
+        stats.large_time++;
+        return {black_scholes_call(S, K, tau, large_vol, r), large_vol, large_error,
+                AsymptoticRegime::LargeTime};
+    }
+    stats.fourier++;
+    HestonPricer pricer(S, K, tau, v, kappa, theta, sigma, rho, r);
+    const PricingEstimate e =
+        pricer.price_call_within(chrono::steady_clock::time_point::max(), FOURIER_TOLERANCE);
+    return {e.price, NAN, e.error_bound, AsymptoticRegime::Fourier};
+}
+
+double HestonAsymptoticPricer::price_call(double K, double tau) {
+    return quote_call(K, tau).price;
+}
+
+double HestonAsymptoticPricer::price_put(double K, double tau) {
+    return price_call(K, tau) - S + K * exp(-r * tau);
+}
@@ -0,0 +1,44 @@
+#ifndef ASYMPTOTIC_H
+#define ASYMPTOTIC_H
+
+enum class AsymptoticRegime { SmallTime, LargeTime, Fourier };
+
+struct AsymptoticQuote {
+    double price;
+    double implied_vol;  // NaN si le prix vient du pricer de Fourier
+    double error;        // erreur estimée: volatilité implicite, ou prix si regime == Fourier
+    AsymptoticRegime regime;
+};
+
+// Nombre de contrats traités par chaque chemin depuis la création du pricer.
+struct AsymptoticStats {
+    long small_time = 0;
+    long large_time = 0;
+    long fourier = 0;
+};
+
+// Développements asymptotiques de la volatilité implicite de Heston:
+//  - petite maturité: smile limite de Forde-Jacquier (transformée de Legendre de la
+//    fonction de taux) plus la correction ATM d'ordre T;
+//  - grande maturité: limite SVI de Gatheral-Jacquier plus la correction en 1/T obtenue
+//    par point-selle (Lewis, Forde-Jacquier-Mijatović).
+// Chaque développement estime son erreur; au-delà de la tolérance on revient à
+// HestonPricer::price_call_within (quadrature adaptative à erreur bornée).
+class HestonAsymptoticPricer {
+public:
+    double S, v, kappa, theta, sigma, rho, r;
+    double tolerance = 1e-3;  // erreur absolue tolérée sur la volatilité implicite
+    AsymptoticStats stats;
+
+    HestonAsymptoticPricer(double S, double v, double kappa, double theta, double sigma,
+                           double rho, double r);
+
+    double small_time_vol(double K, double tau, double& error) const;
+    double large_time_vol(double K, double tau, double& error) const;
+
+    AsymptoticQuote quote_call(double K, double tau);
+    double price_call(double K, double tau);
+    double price_put(double K, double tau);
+};
+
+#endif // ASYMPTOTIC_H
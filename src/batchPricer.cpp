@@ -0,0 +1,267 @@
+#include "batchPricer.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <map>
+#include <numeric>
+#include <vector>
+
+using namespace std;
+constexpr double PI = 3.14159265358979323846;
+
+namespace {
+
+// Intervalle de recalage exact des phases: entre deux recalages, la phase de chaque
+// strike est tournée par récurrence et les sommes partielles restent en Real.
+constexpr int REANCHOR = 256;
+
+// Fonction caractéristique de Heston sans le terme de spot exp(i u log S).
+template <typename Real>
+complex<Real> characteristic_no_spot(complex<Real> u, Real tau, Real v, Real kappa, Real theta,
+                                     Real sigma, Real rho, Real r) {
+    const complex<Real> i(0, 1);
+    const Real one = 1, two = 2;
+    complex<Real> b = kappa - rho * sigma * u * i;
+    complex<Real> d = sqrt(b * b + sigma * sigma * (u * i + u * u));
+    complex<Real> g = (b - d) / (b + d);
+    complex<Real> e = exp(-d * tau);
+
+    complex<Real> C = r * u * i * tau + (kappa * theta) / (sigma * sigma) *
+                                            ((b - d) * tau - two * log((one - g * e) / (one - g)));
+    complex<Real> D = ((b - d) / (sigma * sigma)) * ((one - e) / (one - g * e));
+    return exp(C + D * v);
+}
+
+// Abscisse à laquelle on évalue la limite u -> 0 des intégrandes de P1 et P2.
+constexpr double U_LIMIT = 1e-6;
+
+// Limite en u -> 0 de Re(e^{iu m} psi(u - shift) / (iu)) = Im(e^{iu m} psi(u - shift)) / u,
+// c'est-à-dire l'espérance de ln(S_T / K) sous la mesure de psi (pondérée par psi(-shift)).
+// Évaluée en double: la partie imaginaire est O(u) sans compensation.
+double integrand_limit(double m, complex<double> shift, double tau, double v, double kappa,
+                       double theta, double sigma, double rho, double r) {
+    const complex<double> psi = characteristic_no_spot<double>(
+        complex<double>(U_LIMIT, 0) - shift, tau, v, kappa, theta, sigma, rho, r);
+    return (exp(complex<double>(0, U_LIMIT * m)) * psi).imag() / U_LIMIT;
+}
+
+}  // namespace
+
+HestonBatchPricer::HestonBatchPricer(double S, double v, double kappa, double theta, double sigma,
+                                     double rho, double r)
+    : S(S), v(v), kappa(kappa), theta(theta), sigma(sigma), rho(rho), r(r) {}
+
+bool HestonBatchPricer::near_the_money(const BatchContract& c) const {
+    return fabs(log(c.K / (S * exp(r * c.tau)))) <= refine_band;
+}
+
+template <typename Real>
+HestonBatchPricer::Integrals HestonBatchPricer::integrate(double tau, const vector<double>& strikes,
+                                                          bool with_density) const {
+    const complex<Real> i(0, 1);
+    const Real rt = static_cast<Real>(tau);
+    const Real rv = static_cast<Real>(v), rk = static_cast<Real>(kappa);
+    const Real rth = static_cast<Real>(theta), rs = static_cast<Real>(sigma);
+    const Real rr = static_cast<Real>(rho), rrate = static_cast<Real>(r);
+
+    // Intégrandes stockés en structure de tableaux: Re(e^{iu m} psi / (iu)) = c a + s b,
+    // et pour la densité Re(e^{iu m} psi) = u (c b - s a).
+    vector<Real> a1(N_u), b1(N_u), a0(N_u), b0(N_u), ua0, ub0;
+    for (int n = 0; n < N_u; ++n) {
+        Real u = static_cast<Real>((n + 1) * du);
+        complex<Real> psi1 = characteristic_no_spot<Real>(complex<Real>(u, 0) - i, rt, rv, rk, rth,
+                                                          rs, rr, rrate);
+        complex<Real> psi0 =
+            characteristic_no_spot<Real>(complex<Real>(u, 0), rt, rv, rk, rth, rs, rr, rrate);
+        a1[n] = psi1.imag() / u;
+        b1[n] = psi1.real() / u;
+        a0[n] = psi0.imag() / u;
+        b0[n] = psi0.real() / u;
+    }
+    if (with_density) {
+        ua0.resize(N_u);
+        ub0.resize(N_u);
+        for (int n = 0; n < N_u; ++n) {
+            Real u = static_cast<Real>((n + 1) * du);
+            ua0[n] = a0[n] * u;
+            ub0[n] = b0[n] * u;
+        }
+    }
+
+    const size_t nk = strikes.size();
+    vector<double> m(nk);
+    for (size_t k = 0; k < nk; ++k) {
+        m[k] = log(S / strikes[k]);
+    }
+
+    vector<Real> c(nk), s(nk), rot_c(nk), rot_s(nk), sum1(nk), sum0(nk), sumd(nk);
+    Integrals out;
+    out.I1.assign(nk, 0.0);
+    out.I0.assign(nk, 0.0);
+    out.Id.assign(with_density ? nk : 0, 0.0);
+    for (size_t k = 0; k < nk; ++k) {
+        rot_c[k] = static_cast<Real>(cos(du * m[k]));
+        rot_s[k] = static_cast<Real>(sin(du * m[k]));
+    }
+
+    for (int n0 = 0; n0 < N_u; n0 += REANCHOR) {
+        const int n1 = min(N_u, n0 + REANCHOR);
+        for (size_t k = 0; k < nk; ++k) {
+            double phase = (n0 + 1) * du * m[k];
+            c[k] = static_cast<Real>(cos(phase));
+            s[k] = static_cast<Real>(sin(phase));
+            sum1[k] = 0;
+            sum0[k] = 0;
+            sumd[k] = 0;
+        }
+        for (int n = n0; n < n1; ++n) {
+            const Real A1 = a1[n], B1 = b1[n], A0 = a0[n], B0 = b0[n];
+            if (with_density) {
+                const Real UA0 = ua0[n], UB0 = ub0[n];
+                for (size_t k = 0; k < nk; ++k) {
+                    sum1[k] += c[k] * A1 + s[k] * B1;
+                    sum0[k] += c[k] * A0 + s[k] * B0;
+                    sumd[k] += c[k] * UB0 - s[k] * UA0;
+                    Real cn = c[k] * rot_c[k] - s[k] * rot_s[k];
+                    s[k] = s[k] * rot_c[k] + c[k] * rot_s[k];
+                    c[k] = cn;
+                }
+            } else {
+                for (size_t k = 0; k < nk; ++k) {
+                    sum1[k] += c[k] * A1 + s[k] * B1;
+                    sum0[k] += c[k] * A0 + s[k] * B0;
+                    Real cn = c[k] * rot_c[k] - s[k] * rot_s[k];
+                    s[k] = s[k] * rot_c[k] + c[k] * rot_s[k];
+                    c[k] = cn;
+                }
+            }
+        }
+        for (size_t k = 0; k < nk; ++k) {
+            out.I1[k] += static_cast<double>(sum1[k]);
+            out.I0[k] += static_cast<double>(sum0[k]);
+        }
+        if (with_density) {
+            for (size_t k = 0; k < nk; ++k) {
+                out.Id[k] += static_cast<double>(sumd[k]);
+            }
+        }
+    }
+
+    // Règle des trapèzes: le terme u = 0 reçoit un demi-poids. Pour P1 et P2 c'est la limite
+    // finie E[ln(S_T / K)] de l'intégrande; l'omettre biaise P1 et P2 de O(du), ce qui rend
+    // les prix loin de la monnaie négatifs. Pour la densité c'est psi(0) = 1.
+    const complex<double> i_double(0, 1);
+    for (size_t k = 0; k < nk; ++k) {
+        const double f1 = integrand_limit(m[k], i_double, tau, v, kappa, theta, sigma, rho, r);
+        const double f0 = integrand_limit(m[k], 0.0, tau, v, kappa, theta, sigma, rho, r);
+        out.I1[k] = (out.I1[k] + 0.5 * f1) * du;
+        out.I0[k] = (out.I0[k] + 0.5 * f0) * du;
+    }
+    for (size_t k = 0; k < out.Id.size(); ++k) {
+        out.Id[k] = (out.Id[k] + 0.5) * du;
+    }
+    return out;
+}
+
+template <typename Real>
+vector<double> HestonBatchPricer::price_group(double tau, const vector<BatchContract>& contracts,
+                                              const vector<size_t>& idx) const {
+    vector<double> strikes(idx.size());
+    for (size_t k = 0; k < idx.size(); ++k) {
+        strikes[k] = contracts[idx[k]].K;
+    }
+    Integrals I = integrate<Real>(tau, strikes, false);
+
+    vector<double> prices(idx.size());
+    const double df = exp(-r * tau);
+    for (size_t k = 0; k < idx.size(); ++k) {
+        const BatchContract& ct = contracts[idx[k]];
+        double P1 = 0.5 * S + (df / PI) * S * I.I1[k];
+        double P2 = ct.K * df * (0.5 + (1.0 / PI) * I.I0[k]);
+        double call = P1 - P2;
+        prices[k] = ct.is_call ? call : call - S + ct.K * df;
+    }
+    return prices;
+}
+
+template <typename Real>
+vector<double> HestonBatchPricer::price_all(const vector<BatchContract>& contracts) const {
+    map<double, vector<size_t>> by_tau;
+    for (size_t k = 0; k < contracts.size(); ++k) {
+        by_tau[contracts[k].tau].push_back(k);
+    }
+
+    vector<double> prices(contracts.size());
+    for (const auto& group : by_tau) {
+        vector<double> p = price_group<Real>(group.first, contracts, group.second);
+        for (size_t k = 0; k < group.second.size(); ++k) {
+            prices[group.second[k]] = p[k];
+        }
+    }
+    return prices;
+}
+
+vector<double> HestonBatchPricer::price(const vector<BatchContract>& contracts) const {
+    return price_all<double>(contracts);
+}
+
+vector<BatchQuote> HestonBatchPricer::price_mixed(const vector<BatchContract>& contracts,
+                                                  bool refine_atm, bool measure_error) const {
+    vector<double> low = price_all<float>(contracts);
+    vector<BatchQuote> quotes(contracts.size());
+    for (size_t k = 0; k < contracts.size(); ++k) {
+        quotes[k] = {low[k], 0.0, false};
+    }
+
+    if (measure_error) {
+        vector<double> high = price_all<double>(contracts);
+        for (size_t k = 0; k < contracts.size(); ++k) {
+            quotes[k].error = fabs(low[k] - high[k]);
+            if (refine_atm && near_the_money(contracts[k])) {
+                quotes[k].price = high[k];
+                quotes[k].refined = true;
+            }
+        }
+        return quotes;
+    }
+
+    if (refine_atm) {
+        vector<size_t> atm;
+        vector<BatchContract> subset;
+        for (size_t k = 0; k < contracts.size(); ++k) {
+            if (near_the_money(contracts[k])) {
+                atm.push_back(k);
+                subset.push_back(contracts[k]);
+            }
+        }
+        vector<double> high = price_all<double>(subset);
+        for (size_t j = 0; j < atm.size(); ++j) {
+            BatchQuote& q = quotes[atm[j]];
+            q.error = fabs(q.price - high[j]);
+            q.price = high[j];
+            q.refined = true;
+        }
+    }
+    return quotes;
+}
+
+vector<StrikeDistribution> HestonBatchPricer::distribution(const vector<double>& strikes,
+                                                           double tau) const {
+    Integrals I = integrate<double>(tau, strikes, true);
+
+    vector<StrikeDistribution> out(strikes.size());
+    const double df = exp(-r * tau);
+    for (size_t k = 0; k < strikes.size(); ++k) {
+        const double K = strikes[k];
+        StrikeDistribution& d = out[k];
+        d.K = K;
+        d.share_probability = 0.5 + df * I.I1[k] / PI;
+        d.exercise_probability = 0.5 + I.I0[k] / PI;
+        d.density = I.Id[k] / (PI * K);
+        d.call = S * d.share_probability - K * df * d.exercise_probability;
+        d.put = d.call - S + K * df;
+        d.digital_call = df * d.exercise_probability;
+        d.digital_put = df * (1.0 - d.exercise_probability);
+    }
+    return out;
+}
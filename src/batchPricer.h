@@ -0,0 +1,72 @@
+#ifndef BATCH_PRICER_H
+#define BATCH_PRICER_H
+
+#include <cstddef>
+#include <vector>
+
+struct BatchContract {
+    double K;
+    double tau;
+    bool is_call;
+};
+
+struct BatchQuote {
+    double price;
+    double error;  // |prix float32 - prix double|, renseigné si mesuré ou raffiné
+    bool refined;  // prix recalculé en double précision (proche de la monnaie)
+};
+
+// Quantités risque-neutre extraites d'une même passe de quadrature pour un strike.
+struct StrikeDistribution {
+    double K;
+    double call;
+    double put;
+    double digital_call;          // e^{-r tau} P2
+    double digital_put;           // e^{-r tau} (1 - P2)
+    double exercise_probability;  // P2 = Q(S_T > K)
+    double share_probability;     // P1, probabilité d'exercice sous la mesure action
+    double density;               // densité risque-neutre de S_T en K
+};
+
+// Pricer Heston vectorisé sur un lot de contrats partageant le même sous-jacent.
+// La fonction caractéristique est évaluée une seule fois par maturité puis la
+// quadrature (trapèzes de pas du, terme u = 0 pris à sa limite) est menée pour tous les
+// strikes à la fois, en float ou en double.
+class HestonBatchPricer {
+public:
+    double S, v, kappa, theta, sigma, rho, r;
+    double du = 0.01;
+    int N_u = 10000;
+    double refine_band = 0.1;  // |log(K/F)| sous lequel un contrat est raffiné en double
+
+    HestonBatchPricer(double S, double v, double kappa, double theta, double sigma, double rho,
+                      double r);
+
+    std::vector<double> price(const std::vector<BatchContract>& contracts) const;
+
+    std::vector<BatchQuote> price_mixed(const std::vector<BatchContract>& contracts,
+                                        bool refine_atm = true, bool measure_error = false) const;
+
+    bool near_the_money(const BatchContract& c) const;
+
+    // Digitales, probabilités d'exercice et densité sur une grille de strikes, en une passe.
+    std::vector<StrikeDistribution> distribution(const std::vector<double>& strikes,
+                                                 double tau) const;
+
+private:
+    struct Integrals {
+        std::vector<double> I1, I0, Id;
+    };
+
+    template <typename Real>
+    Integrals integrate(double tau, const std::vector<double>& strikes, bool with_density) const;
+
+    template <typename Real>
+    std::vector<double> price_group(double tau, const std::vector<BatchContract>& contracts,
+                                    const std::vector<std::size_t>& idx) const;
+
+    template <typename Real>
+    std::vector<double> price_all(const std::vector<BatchContract>& contracts) const;
+};
+
+#endif // BATCH_PRICER_H
@@ -0,0 +1,1325 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+#include "asymptotic.h"
+#include "batchPricer.h"
+#include "longstaffSchwartz.h"
+#include "mcGreeks.h"
+#include "monteCarlo.h"
+#include "monteCarloF32.h"
+#include "pricer.h"
+#include "multiAsset.h"
+#include "multilevel.h"
+#include "normalBatch.h"
+#include "numa.h"
+#include "observedPaths.h"
+#include "pathArchive.h"
+#include "payoffs.h"
+#include "pdeSolver.h"
+#include "philox.h"
+#include "qmc.h"
+#include "slv.h"
+#include "syntheticMarket.h"
+#include "varianceReduction.h"
+
+using namespace std;
+
+namespace {
+
+// Cas test commun: la condition de Feller n'est pas satisfaite (2 kappa theta < sigma^2).
+const HestonParams kParams{100.0, 0.03, 1.0, 0.04, 1.5, 0.04, 0.5, -0.7};
+const double kStrike = 100.0;
+
+double seconds_since(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+double reference_call(const HestonParams& p, double K) {
+    HestonPricer pricer(p.S0, K, p.T, p.v0, p.kappa, p.theta, p.sigma, p.rho, p.drift);
+    return pricer.price_call_within(chrono::steady_clock::time_point::max(), 1e-10).price;
+}
+
+// Mode mixte float32 / double de HestonBatchPricer sur une chaîne de 60 contrats: temps de
+// chaque chemin et erreur par contrat du prix float32 contre le même lot en double, hors et
+// dans la bande de raffinement, puis écart du lot double à la quadrature adaptative.
+void bench_mixed() {
+    const HestonParams& p = kParams;
+    const HestonBatchPricer batch(p.S0, p.v0, p.kappa, p.theta, p.sigma, p.rho, p.drift);
+    vector<BatchContract> chain;
+    for (double tau : {0.1, 0.25, 0.5, 1.0, 2.0}) {
+        for (double K : {60.0, 70.0, 80.0, 90.0, 95.0, 100.0, 105.0, 110.0, 120.0, 130.0, 150.0,
+                         180.0}) {
+            chain.push_back({K, tau, true});
+        }
+    }
+    auto start = chrono::steady_clock::now();
+    const vector<double> high = batch.price(chain);
+    const double t_double = seconds_since(start);
+    start = chrono::steady_clock::now();
+    batch.price_mixed(chain, false);
+    const double t_float = seconds_since(start);
+    start = chrono::steady_clock::now();
+    const vector<BatchQuote> refined = batch.price_mixed(chain);
+    const double t_mixed = seconds_since(start);
+    const vector<BatchQuote> measured = batch.price_mixed(chain, false, true);
+
+    double max_far = 0, max_near = 0, max_refined = 0, max_fourier = 0;
+    int near = 0;
+    for (size_t k = 0; k < chain.size(); ++k) {
+        if (batch.near_the_money(chain[k])) {
+            ++near;
+            max_near = max(max_near, measured[k].error);
+            max_refined = max(max_refined, fabs(refined[k].price - high[k]));
+        } else {
+            max_far = max(max_far, measured[k].error);
+        }
+        HestonParams q = p;
+        q.T = chain[k].tau;
+        max_fourier = max(max_fourier, fabs(high[k] - reference_call(q, chain[k].K)));
+    }
+    printf("Prix en précision mixte: %zu calls, %d dans la bande |ln K/F| < %.2f\n",
+           chain.size(), near, batch.refine_band);
+    printf("double %.3fs, float32 %.3fs (gain x%.2f), float32 + raffinement %.3fs\n", t_double,
+           t_float, t_double / t_float, t_mixed);
+    printf("erreur max float32 - double: hors bande %.1e, dans la bande %.1e "
+           "(%.1e après raffinement)\n", max_far, max_near, max_refined);
+    printf("erreur max du lot double contre price_call_within à 1e-10: %.1e\n\n", max_fourier);
+}
+
+// Digitales et calls de HestonBatchPricer::distribution contre la quadrature adaptative de
+// HestonPricer (digitale par différences finies en K), jusque loin hors de la monnaie.
+void bench_distribution() {
+    const HestonParams& p = kParams;
+    const HestonBatchPricer batch(p.S0, p.v0, p.kappa, p.theta, p.sigma, p.rho, p.drift);
+    const vector<double> strikes = {60, 80, 100, 120, 150, 180};
+    const vector<StrikeDistribution> dist = batch.distribution(strikes, p.T);
+    printf("Distribution en une passe (tau = %.0f) contre price_call_within à 1e-10\n", p.T);
+    printf("%6s %12s %12s %10s %12s %12s %10s\n", "K", "call", "référence", "écart",
+           "digitale", "référence", "écart");
+    for (size_t k = 0; k < strikes.size(); ++k) {
+        const double K = strikes[k], h = 1e-3 * K;
+        auto call = [&p](double strike) { return reference_call(p, strike); };
+        const double ref_call = call(K);
+        const double ref_digital = (call(K - h) - call(K + h)) / (2 * h);
+        printf("%6.0f %12.6f %12.6f %10.1e %12.6f %12.6f %10.1e\n", K, dist[k].call, ref_call,
+               dist[k].call - ref_call, dist[k].digital_call, ref_digital,
+               dist[k].digital_call - ref_digital);
+    }
+    printf("\n");
+}
+
+// Solveur EDP ADI (grille 200 x 100, 100 pas) contre la quadrature adaptative de HestonPricer
+// (grecques par différences centrées à 1e-10) et HestonGreeks, puis temps du solve et coût d'un
+// balayage parallèle: threads créés à chaque appel (parallel_for) ou réutilisés (ThreadTeam).
+void bench_pde() {
+    const HestonParams& p = kParams;
+    HestonPDESolver pde(kStrike, p.T, p.kappa, p.theta, p.sigma, p.rho, p.drift);
+    pde.threads = 1;
+    auto start = chrono::steady_clock::now();
+    const PDESolution sol = pde.solve_call();
+    const double t_single = seconds_since(start);
+
+    printf("EDP de Heston (ADI, grille %d x %d, %d pas) contre price_call_within à 1e-10\n",
+           pde.m1, pde.m2, pde.N);
+    printf("%6s %8s %12s %12s %10s %12s\n", "S", "grecque", "EDP", "référence", "écart",
+           "HestonGreeks");
+    for (double S : {80.0, 100.0, 120.0}) {
+        const double h = 0.01 * S, dv = 1e-4;
+        HestonParams q = p;
+        auto call = [&q](double spot, double variance) {
+            q.S0 = spot;
+            q.v0 = variance;
+            return reference_call(q, kStrike);
+        };
+        const double c = call(S, p.v0), up = call(S + h, p.v0), down = call(S - h, p.v0);
+        HestonGreeks fixed(S, kStrike, p.T, p.v0, p.kappa, p.theta, p.sigma, p.rho, p.drift);
+        const struct {
+            const char* name;
+            const vector<double>& field;
+            double reference;
+            double greeks;
+        } rows[] = {
+            {"prix", sol.price, c, fixed.price_call()},
+            {"delta", sol.delta, (up - down) / (2 * h), fixed.delta()},
+            {"gamma", sol.gamma, (up - 2 * c + down) / (h * h), fixed.gamma()},
+            // HestonGreeks::vega est une différence seconde en v: pas de colonne comparable.
+            {"vega", sol.vega, (call(S, p.v0 + dv) - call(S, p.v0 - dv)) / (2 * dv), NAN},
+        };
+        for (const auto& row : rows) {
+            const double value = sol.value_at(row.field, S, p.v0);
+            printf("%6.0f %8s %12.6f %12.6f %10.1e %12.6f\n", S, row.name, value, row.reference,
+                   value - row.reference, row.greeks);
+        }
+    }
+
+    const int threads = max(4, default_thread_count());
+    pde.threads = threads;
+    start = chrono::steady_clock::now();
+    pde.solve_call();
+    const double t_multi = seconds_since(start);
+    printf("solve: %.3fs sur 1 thread, %.3fs sur %d threads (%d coeur(s))\n", t_single, t_multi,
+           threads, default_thread_count());
+
+    // Six balayages par pas de temps ADI: coût fixe d'un appel à corps vide.
+    const int calls = 6 * pde.N;
+    start = chrono::steady_clock::now();
+    for (int k = 0; k < calls; ++k) {
+        parallel_for(0, pde.m2, threads, [](long, long) {});
+    }
+    const double t_spawn = seconds_since(start);
+    ThreadTeam team(threads);
+    start = chrono::steady_clock::now();
+    for (int k = 0; k < calls; ++k) {
+        team.parallel_for(0, pde.m2, [](long, long) {});
+    }
+    const double t_team = seconds_since(start);
+    printf("%d balayages vides sur %d threads: parallel_for %.1f us/appel, ThreadTeam %.1f "
+           "us/appel\n\n", calls, threads, 1e6 * t_spawn / calls, 1e6 * t_team / calls);
+}
+
+// Prix sous échéance: price_call_within avec des budgets de latence serrés. Noeuds
+// évalués, borne d'erreur annoncée et erreur réelle contre la quadrature à 1e-10, à
+// comparer aux 10 000 noeuds de price_call.
+void bench_deadline() {
+    const HestonParams& p = kParams;
+    printf("Prix sous échéance (price_call_within, tolérance 1e-8)\n");
+    printf("%6s %10s %8s %12s %10s %10s %10s\n", "K", "budget", "noeuds", "prix", "borne",
+           "erreur", "temps");
+    for (double K : {100.0, 150.0}) {
+        const double ref = reference_call(p, K);
+        HestonPricer pricer(p.S0, K, p.T, p.v0, p.kappa, p.theta, p.sigma, p.rho, p.drift);
+        for (double budget : {0.0, 5e-5, 2e-4, 1e-3, 5e-3}) {
+            auto start = chrono::steady_clock::now();
+            const PricingEstimate e = pricer.price_call_within(
+                start + chrono::duration_cast<chrono::steady_clock::duration>(
+                            chrono::duration<double>(budget)));
+            const double elapsed = seconds_since(start);
+            printf("%6.0f %8.0fus %8d %12.8f %10.1e %10.1e %8.0fus%s\n", K, 1e6 * budget,
+                   e.nodes, e.price, e.error_bound, fabs(e.price - ref), 1e6 * elapsed,
+                   e.converged ? "" : " (échéance)");
+        }
+        auto start = chrono::steady_clock::now();
+        const double full = pricer.price_call();
+        printf("%6.0f %10s %8d %12.8f %10s %10.1e %8.0fus\n", K, "price_call", 10000, full, "-",
+               fabs(full - ref), 1e6 * seconds_since(start));
+    }
+    printf("\n");
+}
+
+// Fréquence et précision des régimes asymptotiques de HestonAsymptoticPricer: par maturité,
+// contrats servis par chaque chemin (petite maturité, grande maturité, repli Fourier), écart
+// de prix à la quadrature à 1e-10 et écart en volatilité implicite (écart de prix divisé par
+// le vega Black-Scholes) contre l'erreur que le développement s'attribue.
+void bench_asymptotic() {
+    const HestonParams& p = kParams;
+    HestonAsymptoticPricer pricer(p.S0, p.v0, p.kappa, p.theta, p.sigma, p.rho, p.drift);
+    const vector<double> strikes = {70, 80, 90, 100, 110, 120, 130};
+    printf("Régimes asymptotiques (tolérance %.0e en vol), %zu strikes par maturité\n",
+           pricer.tolerance, strikes.size());
+    printf("%6s %6s %6s %7s %10s %10s %10s %9s %9s\n", "tau", "petit", "grand", "Fourier",
+           "écart prix", "écart vol", "vol estim.", "asympt.", "Fourier");
+    for (double tau : {0.005, 0.02, 0.05, 0.1, 0.5, 1.0, 5.0, 10.0, 20.0, 50.0}) {
+        const AsymptoticStats before = pricer.stats;
+        double price_gap = 0, vol_gap = 0, vol_estimate = 0, t_quote = 0, t_fourier = 0;
+        for (double K : strikes) {
+            auto start = chrono::steady_clock::now();
+            const AsymptoticQuote q = pricer.quote_call(K, tau);
+            t_quote += seconds_since(start);
+            HestonParams ref_params = p;
+            ref_params.T = tau;
+            start = chrono::steady_clock::now();
+            const double ref = reference_call(ref_params, K);
+            t_fourier += seconds_since(start);
+            price_gap = max(price_gap, fabs(q.price - ref));
+            if (q.regime != AsymptoticRegime::Fourier) {
+                const double d1 = (log(p.S0 / K) + (p.drift + 0.5 * q.implied_vol * q.implied_vol) *
+                                   tau) / (q.implied_vol * sqrt(tau));
+                const double vega = p.S0 * norm_pdf(d1) * sqrt(tau);
+                vol_gap = max(vol_gap, fabs(q.price - ref) / vega);
+                vol_estimate = max(vol_estimate, q.error);
+            }
+        }
+        const double n = static_cast<double>(strikes.size());
+        printf("%6.3g %6ld %6ld %7ld %10.1e %10.1e %10.1e %7.0fus %7.0fus\n", tau,
+               pricer.stats.small_time - before.small_time,
+               pricer.stats.large_time - before.large_time, pricer.stats.fourier - before.fourier,
+               price_gap, vol_gap, vol_estimate, 1e6 * t_quote / n, 1e6 * t_fourier / n);
+    }
+    printf("total: %ld petite maturité, %ld grande maturité, %ld repli Fourier\n\n",
+           pricer.stats.small_time, pricer.stats.large_time, pricer.stats.fourier);
+}
+
+// Biais du call en fonction du nombre de pas, Euler tronqué contre QE.
+void bench_scheme_bias() {
+    const HestonParams& p = kParams;
+    const double K = kStrike;
+    const double ref = reference_call(p, K);
+    const double discount = exp(-p.drift * p.T);
+    const long M = 400000;
+    auto payoff = [K](double ST) { return ST > K ? ST - K : 0.0; };
+
+    printf("Biais Euler / QE (M = %ld, prix Fourier = %.6f)\n", M, ref);
+    printf("%6s %12s %10s %12s %10s\n", "N", "biais Euler", "t Euler", "biais QE", "t QE");
+    for (int N : {1, 2, 4, 8, 16, 32, 64, 128, 256}) {
+        auto start = chrono::steady_clock::now();
+        MonteCarloResult euler = heston_mc_parallel(p, N, M, payoff, 42, 0, 2048, Scheme::Euler);
+        double t_euler = seconds_since(start);
+        start = chrono::steady_clock::now();
+        MonteCarloResult qe = heston_mc_parallel(p, N, M, payoff, 42, 0, 2048, Scheme::QE);
+        double t_qe = seconds_since(start);
+        printf("%6d %12.4f %9.2fs %12.4f %9.2fs\n", N, discount * euler.estimate - ref, t_euler,
+               discount * qe.estimate - ref, t_qe);
+    }
+    printf("erreur type ~ %.4f\n\n", discount * heston_mc_parallel(p, 1, M, payoff, 42).std_error);
+}
+
+// Coût et biais de l'échantillonnage exact contre les schémas à pas, selon la maturité.
+void bench_exact_sampling() {
+    const long M = 200000;
+    const double K = kStrike;
+    auto payoff = [K](double ST) { return ST > K ? ST - K : 0.0; };
+
+    printf("Échantillonnage exact / schémas à pas (M = %ld)\n", M);
+    printf("%5s %-12s %10s %10s %12s\n", "T", "schéma", "biais", "erreur", "us/traj.");
+    for (double T : {0.5, 1.0, 5.0, 10.0}) {
+        HestonParams p = kParams;
+        p.T = T;
+        const double ref = reference_call(p, K);
+        const double discount = exp(-p.drift * T);
+        struct Run {
+            const char* name;
+            Scheme scheme;
+            int N;
+        };
+        const int euler_steps = static_cast<int>(lround(100 * T));
+        const int qe_steps = max(1, static_cast<int>(lround(8 * T)));
+        for (const Run& run : {Run{"Euler 100/an", Scheme::Euler, euler_steps},
+                               Run{"QE 8/an", Scheme::QE, qe_steps},
+                               Run{"exact", Scheme::Exact, 1}}) {
+            auto start = chrono::steady_clock::now();
+            MonteCarloResult res = heston_mc_parallel(p, run.N, M, payoff, 42, 0, 2048, run.scheme);
+            double elapsed = seconds_since(start);
+            printf("%5.1f %-12s %10.4f %10.4f %12.3f\n", T, run.name,
+                   discount * res.estimate - ref, discount * res.std_error, 1e6 * elapsed / M);
+        }
+    }
+    printf("\n");
+}
+
+// Reproductibilité: heston_mc_parallel et heston_mc_payoff sur 1 thread puis sur 2, 3 et 8
+// threads (découpages différents des blocs entre threads); les résultats doivent être
+// identiques au bit près, y compris l'erreur type.
+void bench_determinism() {
+    const HestonParams& p = kParams;
+    const double K = kStrike;
+    const int N = 50;
+    const long M = 100000;
+    auto call = [K](double ST) { return ST > K ? ST - K : 0.0; };
+    auto same = [](const MonteCarloResult& a, const MonteCarloResult& b) {
+        return memcmp(&a.estimate, &b.estimate, sizeof(double)) == 0 &&
+               memcmp(&a.std_error, &b.std_error, sizeof(double)) == 0 && a.paths == b.paths;
+    };
+    printf("Reproductibilité selon le nombre de threads (N = %d, M = %ld)\n", N, M);
+    printf("%-16s %18s %10s %10s %10s\n", "moteur", "1 thread", "2", "3", "8");
+    const struct {
+        const char* name;
+        Scheme scheme;
+    } schemes[] = {{"Euler", Scheme::Euler}, {"QE", Scheme::QE}, {"exact", Scheme::Exact}};
+    for (const auto& run : schemes) {
+        const MonteCarloResult single = heston_mc_parallel(p, N, M, call, 42, 1, 2048, run.scheme);
+        printf("%-16s %18.12f", run.name, single.estimate);
+        for (int threads : {2, 3, 8}) {
+            const MonteCarloResult r = heston_mc_parallel(p, N, M, call, 42, threads, 2048,
+                                                          run.scheme);
+            printf(" %10s", same(single, r) ? "identique" : "DIFFÉRENT");
+        }
+        printf("\n");
+    }
+    const MonteCarloResult asian = heston_mc_payoff(p, N, M, ArithmeticAsianCall(K), 42, 1);
+    printf("%-16s %18.12f", "asiatique", asian.estimate);
+    for (int threads : {2, 3, 8}) {
+        const MonteCarloResult r = heston_mc_payoff(p, N, M, ArithmeticAsianCall(K), 42, threads);
+        printf(" %10s", same(asian, r) ? "identique" : "DIFFÉRENT");
+    }
+    printf("\n");
+
+    // NormalBatch::fill (compilé en -O3) contre philox_normal_pair tirage par tirage, puis
+    // débit: normales scalaires, uniformes par lots (tours Philox), normales par lots.
+    const long n = 2048;
+    const int steps = 1000;
+    const double sqrt_dt = sqrt(p.T / N), rho_bar = sqrt(1 - p.rho * p.rho);
+    NormalBatch batch(n);
+    vector<double> w1(n), w2(n);
+    long mismatches = 0;
+    for (int i = 1; i <= 20; ++i) {
+        batch.fill(42, 1000, n, i, p.rho, sqrt_dt);
+        for (long m = 0; m < n; ++m) {
+            double z1, z2;
+            philox_normal_pair(42, 1000 + m, i, z1, z2);
+            w1[m] = sqrt_dt * z1;
+            w2[m] = sqrt_dt * (p.rho * z1 + rho_bar * z2);
+        }
+        mismatches += memcmp(w1.data(), batch.w1(), n * sizeof(double)) != 0;
+        mismatches += memcmp(w2.data(), batch.w2(), n * sizeof(double)) != 0;
+    }
+    printf("NormalBatch::fill contre philox_normal_pair, 20 pas x %ld trajectoires: %s\n", n,
+           mismatches == 0 ? "identiques au bit près" : "DIFFÉRENTS");
+
+    double checksum = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i = 1; i <= steps; ++i) {
+        for (long m = 0; m < n; ++m) {
+            double z1, z2;
+            philox_normal_pair(42, m, i, z1, z2);
+            w1[m] = z1;
+            w2[m] = z2;
+        }
+        checksum += w1[i % n] + w2[i % n];
+    }
+    const double t_scalar = seconds_since(start);
+    start = chrono::steady_clock::now();
+    for (int i = 1; i <= steps; ++i) {
+        batch.fill_uniforms(42, 0, n, i);
+        checksum += batch.w1()[i % n];
+    }
+    const double t_uniforms = seconds_since(start);
+    start = chrono::steady_clock::now();
+    for (int i = 1; i <= steps; ++i) {
+        batch.fill_independent(42, 0, n, i);
+        checksum += batch.w1()[i % n] + batch.w2()[i % n];
+    }
+    const double t_normals = seconds_since(start);
+    const double pairs = static_cast<double>(n) * steps;
+    printf("ns par paire: philox_normal_pair %.1f, uniformes par lots %.1f, normales par lots "
+           "%.1f (gain x%.2f) [%.3g]\n\n", 1e9 * t_scalar / pairs, 1e9 * t_uniforms / pairs,
+           1e9 * t_normals / pairs, t_scalar / t_normals, checksum);
+}
+
+// Erreur type QMC (Sobol brouillé + pont brownien) contre Monte Carlo à nombre égal de
+// trajectoires, pour un call européen et un call asiatique arithmétique.
+void bench_qmc() {
+    const HestonParams& p = kParams;
+    const double K = kStrike;
+    const int N = 32;
+    const double discount = exp(-p.drift * p.T);
+    auto call = [K](const PathView& path) {
+        double ST = path.S[path.S.size - 1];
+        return ST > K ? ST - K : 0.0;
+    };
+    auto asian = [K](const PathView& path) {
+        double sum = 0;
+        for (int i = 1; i < path.S.size; ++i) {
+            sum += path.S[i];
+        }
+        double average = sum / (path.S.size - 1);
+        return average > K ? average - K : 0.0;
+    };
+
+    QmcConfig mc, qmc;
+    mc.scheme = qmc.scheme = Scheme::QE;
+    mc.sobol_dimensions = 0;
+    mc.brownian_bridge = false;
+    printf("QMC / MC, N = %d, %d répliques (erreurs types actualisées)\n", N, qmc.replicates);
+    printf("%8s %10s %10s %8s %10s %10s %8s\n", "M/rép.", "call MC", "call QMC", "gain",
+           "asiat. MC", "asiat. QMC", "gain");
+    for (long M = 1024; M <= 16384; M *= 4) {
+        double e[4] = {
+            heston_qmc(p, N, M, call, 42, mc).std_error,
+            heston_qmc(p, N, M, call, 42, qmc).std_error,
+            heston_qmc(p, N, M, asian, 42, mc).std_error,
+            heston_qmc(p, N, M, asian, 42, qmc).std_error,
+        };
+        // gain: facteur sur le nombre de trajectoires à précision égale.
+        printf("%8ld %10.5f %10.5f %8.1f %10.5f %10.5f %8.1f\n", M, discount * e[0],
+               discount * e[1], e[0] * e[0] / (e[1] * e[1]), discount * e[2], discount * e[3],
+               e[2] * e[2] / (e[3] * e[3]));
+    }
+    // Intervalle à 95 % sur les répliques: quantile de Student à replicates - 1 degrés.
+    const MonteCarloResult r = heston_qmc(p, N, 16384, call, 42, qmc);
+    printf("call QMC, M = 16384: %.5f, IC 95 %% [%.5f, %.5f] (t à %d degrés = %.3f)\n\n",
+           discount * r.estimate, discount * r.ci_low, discount * r.ci_high, qmc.replicates - 1,
+           student_t_975(qmc.replicates - 1));
+}
+
+// Antithétiques et variable de contrôle (call Fourier à la monnaie) sur des payoffs
+// terminaux et dépendant du chemin (asiatique arithmétique, call up-and-out).
+void bench_variance_reduction() {
+    const HestonParams& p = kParams;
+    const int N = 16;
+    const long M = 200000;
+    const double discount = exp(-p.drift * p.T);
+    struct Case {
+        const char* name;
+        function<double(double)> payoff;
+    };
+    const vector<Case> cases = {
+        {"call K=110", [](double ST) { return ST > 110 ? ST - 110 : 0.0; }},
+        {"put K=90", [](double ST) { return ST < 90 ? 90 - ST : 0.0; }},
+        {"digitale K=100", [](double ST) { return ST > 100 ? 1.0 : 0.0; }},
+    };
+    struct Mode {
+        const char* name;
+        bool antithetic;
+        bool control_variate;
+    };
+    const Mode modes[] = {{"simple", false, false},
+                          {"antithétique", true, false},
+                          {"contrôle", false, true},
+                          {"les deux", true, true}};
+
+    printf("Réduction de variance (QE, N = %d, M = %ld)\n", N, M);
+    printf("%-16s %-14s %10s %10s %8s %8s\n", "payoff", "mode", "prix", "erreur", "beta",
+           "facteur");
+    for (const Case& c : cases) {
+        for (const Mode& mode : modes) {
+            VarianceReduction options;
+            options.antithetic = mode.antithetic;
+            options.control_variate = mode.control_variate;
+            options.scheme = Scheme::QE;
+            VarianceReductionResult r = heston_mc_reduced(p, N, M, c.payoff, 42, options);
+            printf("%-16s %-14s %10.4f %10.5f %8.3f %8.1f\n", c.name, mode.name,
+                   discount * r.result.estimate, discount * r.result.std_error, r.beta,
+                   r.variance_reduction);
+        }
+    }
+    // Payoffs dépendant du chemin (politiques de payoffs.h), même contrôle call européen.
+    auto path_case = [&](const char* name, const auto& policy) {
+        for (const Mode& mode : modes) {
+            VarianceReduction options;
+            options.antithetic = mode.antithetic;
+            options.control_variate = mode.control_variate;
+            options.scheme = Scheme::QE;
+            VarianceReductionResult r = heston_mc_reduced_path(p, N, M, policy, 42, options);
+            printf("%-16s %-14s %10.4f %10.5f %8.3f %8.1f\n", name, mode.name,
+                   discount * r.result.estimate, discount * r.result.std_error, r.beta,
+                   r.variance_reduction);
+        }
+    };
+    path_case("asiatique K=100", ArithmeticAsianCall(100));
+    path_case("up-out 100/130", BarrierCall<BarrierType::UpAndOut>(100, 130));
+    printf("\n");
+}
+
+// Coût du Monte Carlo multiniveau contre un MC à un seul niveau de même RMSE, pour une
+// asiatique arithmétique et un call up-and-out à barrière continue.
+void bench_mlmc() {
+    const HestonParams& p = kParams;
+    const double K = kStrike, barrier = 130.0;
+    auto asian = [K](const PathView& path) {
+        double sum = 0;
+        for (int i = 1; i < path.S.size; ++i) {
+            sum += path.S[i];
+        }
+        double average = sum / (path.S.size - 1);
+        return average > K ? average - K : 0.0;
+    };
+    // Barrière continue: probabilité de survie du pont brownien entre deux dates, ce qui rend
+    // le payoff lipschitzien et accélère la décroissance de Var[P_l - P_{l-1}].
+    auto up_and_out = [K, barrier, T = p.T](const PathView& path) {
+        const double dt = T / (path.S.size - 1);
+        double survival = 1.0;
+        for (int i = 1; i < path.S.size && survival > 0; ++i) {
+            if (path.S[i] >= barrier) {
+                return 0.0;
+            }
+            double a = log(barrier / path.S[i - 1]), b = log(barrier / path.S[i]);
+            double var = max(path.v[i - 1], 1e-12) * dt;
+            survival *= 1 - exp(-2 * a * b / var);
+        }
+        double ST = path.S[path.S.size - 1];
+        return ST > K ? survival * (ST - K) : 0.0;
+    };
+
+    printf("Monte Carlo multiniveau (Euler, N_0 = 16)\n");
+    printf("%-12s %8s %10s %10s %7s %12s %12s %7s\n", "payoff", "RMSE", "prix", "erreur",
+           "niveaux", "coût MLMC", "coût MC", "gain");
+    auto run = [&](const char* name, auto payoff, vector<double> targets) {
+        for (double eps : targets) {
+            MlmcResult r = heston_mlmc(p, payoff, eps, 42);
+            // MC simple au niveau le plus fin: 2 Var[P_L] / eps^2 trajectoires de N_L pas.
+            const MlmcLevel& finest = r.levels.back();
+            double mc_cost = 2 * finest.fine_variance / (eps * eps) * finest.steps;
+            printf("%-12s %8.3f %10.4f %10.4f %7zu %12.3g %12.3g %7.1f\n", name, eps,
+                   exp(-p.drift * p.T) * r.estimate, exp(-p.drift * p.T) * r.std_error,
+                   r.levels.size(), r.cost, mc_cost, mc_cost / r.cost);
+        }
+    };
+    run("asiatique", asian, {0.05, 0.025, 0.0125});
+    // Le biais de la barrière décroît lentement (ordre h^1/2): cibles plus larges.
+    run("up-and-out", up_and_out, {0.1, 0.05});
+    printf("\n");
+}
+
+// Grecques pathwise / rapport de vraisemblance d'une seule simulation, comparées aux chocs
+// centrés du même Monte Carlo à nombres aléatoires communs (même schéma, même graine: même
+// biais de discrétisation) et aux chocs de la formule de Fourier. La colonne Fourier inclut
+// donc le biais d'Euler, important pour sigma et theta hors condition de Feller.
+void bench_greeks() {
+    const HestonParams& p = kParams;
+    const double K = kStrike;
+    const int N = 100;
+    const long M = 200000;
+    auto call = [K](double ST) { return ST > K ? ST - K : 0.0; };
+    auto call_derivative = [K](double ST) { return ST > K ? 1.0 : 0.0; };
+
+    auto start = chrono::steady_clock::now();
+    MonteCarloGreeks g = heston_mc_greeks(p, N, M, call, call_derivative, 42);
+    const double t_greeks = seconds_since(start);
+
+    // Chocs centrés à nombres aléatoires communs et chocs de Fourier (non actualisés).
+    auto monte_carlo = [&](const HestonParams& q) {
+        return heston_mc_parallel(q, N, M, call, 42).estimate;
+    };
+    auto fourier = [K](const HestonParams& q) { return control_expectation(q, K); };
+    auto bump = [&p](const auto& price, double HestonParams::*field, double h) {
+        HestonParams up = p, down = p;
+        up.*field += h;
+        down.*field -= h;
+        return (price(up) - price(down)) / (2 * h);
+    };
+    auto second = [&p](const auto& price, double h) {
+        HestonParams up = p, down = p;
+        up.S0 += h;
+        down.S0 -= h;
+        return (price(up) - 2 * price(p) + price(down)) / (h * h);
+    };
+    struct Row {
+        const char* name;
+        const MonteCarloResult* pathwise;
+        const MonteCarloResult* likelihood;
+        double HestonParams::*field;
+        double h_crn, h_fourier;
+    };
+    const Row rows[] = {
+        {"delta", &g.delta, &g.delta_lr, &HestonParams::S0, 1.0, 0.01},
+        {"gamma", &g.gamma, &g.gamma_lr, nullptr, 1.0, 1.0},
+        {"vega", &g.vega, &g.vega_lr, &HestonParams::v0, 1e-3, 1e-4},
+        {"kappa", &g.dkappa, nullptr, &HestonParams::kappa, 1e-2, 1e-4},
+        {"theta", &g.dtheta, nullptr, &HestonParams::theta, 1e-3, 1e-4},
+        {"sigma", &g.dsigma, nullptr, &HestonParams::sigma, 1e-2, 1e-4},
+        {"rho", &g.drho, nullptr, &HestonParams::rho, 1e-2, 1e-4},
+    };
+
+    printf("Grecques MC (Euler, N = %d, M = %ld, non actualisées)\n", N, M);
+    printf("%-8s %11s %9s %11s %9s %11s %11s\n", "", "pathwise", "erreur", "vraisemb.",
+           "erreur", "chocs NAC", "Fourier");
+    printf("%-8s %11.5f %9.5f %11s %9s %11.5f %11.5f\n", "prix", g.price.estimate,
+           g.price.std_error, "-", "-", monte_carlo(p), fourier(p));
+    start = chrono::steady_clock::now();
+    for (const Row& r : rows) {
+        const double crn = r.field ? bump(monte_carlo, r.field, r.h_crn)
+                                   : second(monte_carlo, r.h_crn);
+        const double ref = r.field ? bump(fourier, r.field, r.h_fourier)
+                                   : second(fourier, r.h_fourier);
+        printf("%-8s %11.5f %9.5f ", r.name, r.pathwise->estimate, r.pathwise->std_error);
+        if (r.likelihood) {
+            printf("%11.5f %9.5f ", r.likelihood->estimate, r.likelihood->std_error);
+        } else {
+            printf("%11s %9s ", "-", "-");
+        }
+        printf("%11.5f %11.5f\n", crn, ref);
+    }
+    const double t_bumps = seconds_since(start);
+    printf("NAC: nombres aléatoires communs (même graine, même grille d'Euler que pathwise);\n");
+    printf("Fourier: modèle continu, l'écart à NAC est le biais de discrétisation.\n");
+    printf("temps: une simulation %.2fs, recalcul par chocs NAC %.2fs\n\n", t_greeks, t_bumps);
+}
+
+// Archive de trajectoires projetée en mémoire: débit d'écriture, puis lecture par date et
+// par trajectoire sans copie. Le call terminal relu de l'archive doit coïncider au bit près
+// avec heston_mc_parallel (mêmes tirages, mêmes blocs).
+void bench_path_archive() {
+    const HestonParams& p = kParams;
+    const double K = kStrike;
+    const int N = 100;
+    const long M = 200000, chunk = 2048;
+    const string file = (filesystem::temp_directory_path() / "heston_paths.bin").string();
+    auto call = [K](double ST) { return ST > K ? ST - K : 0.0; };
+
+    auto start = chrono::steady_clock::now();
+    PathArchiveHeader header = write_path_archive(file, p, N, M, 42, Scheme::Euler, chunk);
+    const double t_write = seconds_since(start);
+    const double gb = header.file_bytes() / 1e9;
+    printf("Archive %s: N = %d, M = %ld, %.2f Go\n", file.c_str(), N, M, gb);
+    printf("écriture: %.2fs (%.2f Go/s)\n", t_write, gb / t_write);
+
+    {
+        PathArchive archive(file);
+        start = chrono::steady_clock::now();
+        RunningStats terminal;
+        archive.for_each_step(N, [&](long, const StepView& step) {
+            RunningStats chunk_stats;
+            for (long m = 0; m < step.size; ++m) {
+                chunk_stats.add(call(step.S[m]));
+            }
+            terminal.merge(chunk_stats);
+        });
+        // Moyenne de S à chaque date: martingale actualisée, S0 e^{rt} attendu.
+        double worst = 0;
+        for (int i = 1; i <= N; ++i) {
+            double sum = 0;
+            archive.for_each_step(i, [&](long, const StepView& step) {
+                for (long m = 0; m < step.size; ++m) {
+                    sum += step.S[m];
+                }
+            });
+            double expected = p.S0 * exp(p.drift * p.T * i / N);
+            worst = max(worst, fabs(sum / M - expected));
+        }
+        const double t_step = seconds_since(start);
+
+        start = chrono::steady_clock::now();
+        RunningStats asian;
+        archive.for_each_path([&](long, const PathView& path) {
+            double sum = 0;
+            for (int i = 1; i <= N; ++i) {
+                sum += path.S[i];
+            }
+            asian.add(max(sum / N - K, 0.0));
+        });
+        const double t_path = seconds_since(start);
+
+        MonteCarloResult direct = heston_mc_parallel(p, N, M, call, 42, 0, chunk);
+        printf("lecture par date: %.2fs, écart max E[S_t] - S0 e^{rt} = %.4f\n", t_step, worst);
+        printf("lecture par trajectoire: %.2fs, asiatique %.5f +- %.5f\n", t_path,
+               asian.mean(), make_result(asian).std_error);
+        printf("call terminal: archive %.10f, heston_mc_parallel %.10f (%s)\n\n",
+               terminal.mean(), direct.estimate,
+               terminal.mean() == direct.estimate ? "identiques" : "différents");
+    }
+    filesystem::remove(file);
+}
+
+// Monte Carlo adaptatif: trajectoires et temps nécessaires par tolérance relative, puis arrêt
+// sur échéance; l'intervalle doit couvrir le prix de Fourier (au biais d'Euler près).
+void bench_adaptive() {
+    const HestonParams& p = kParams;
+    const double K = kStrike;
+    const int N = 16;
+    const double discount = exp(-p.drift * p.T);
+    const double ref = reference_call(p, K);
+    auto call = [K](double ST) { return ST > K ? ST - K : 0.0; };
+
+    printf("MC adaptatif (QE, N = %d), référence Fourier %.5f\n", N, ref);
+    printf("%-16s %10s %20s %10s %8s %6s %s\n", "arrêt", "prix", "IC 95 %", "M", "temps",
+           "lots", "");
+    auto report = [&](const char* label, const AdaptiveMonteCarloResult& r) {
+        char ci[64];
+        snprintf(ci, sizeof(ci), "[%.4f, %.4f]", discount * r.result.ci_low,
+                 discount * r.result.ci_high);
+        printf("%-16s %10.5f %20s %10ld %7.2fs %6d %s\n", label,
+               discount * r.result.estimate, ci, r.result.paths, r.seconds, r.batches,
+               r.converged ? "" : "(échéance)");
+    };
+    bool same = false;
+    for (double tol : {1e-2, 5e-3, 2.5e-3, 1.25e-3}) {
+        AdaptiveStopping stop;
+        stop.relative_tolerance = tol;
+        char label[32];
+        snprintf(label, sizeof(label), "relatif %.2g", tol);
+        AdaptiveMonteCarloResult r = heston_mc_adaptive(p, N, call, 42, stop, 0, 2048, Scheme::QE);
+        report(label, r);
+        if (tol == 2.5e-3) {
+            // Même découpage en blocs que heston_mc_parallel: estimations identiques.
+            same = r.result.estimate ==
+                   heston_mc_parallel(p, N, r.result.paths, call, 42, 0, 2048, Scheme::QE).estimate;
+        }
+    }
+    AdaptiveStopping absolute;
+    absolute.relative_tolerance = 0;
+    absolute.absolute_tolerance = 0.02;
+    report("absolu 0.02", heston_mc_adaptive(p, N, call, 42, absolute, 0, 2048, Scheme::QE));
+    for (double budget : {0.1, 0.5}) {
+        AdaptiveStopping stop;
+        stop.relative_tolerance = 1e-4;
+        stop.deadline = chrono::steady_clock::now() +
+                        chrono::duration_cast<chrono::steady_clock::duration>(
+                            chrono::duration<double>(budget));
+        char label[32];
+        snprintf(label, sizeof(label), "budget %.1fs", budget);
+        report(label, heston_mc_adaptive(p, N, call, 42, stop, 0, 2048, Scheme::QE));
+    }
+    printf("identique à heston_mc_parallel au même M: %s\n\n", same ? "oui" : "non");
+}
+
+// Approche « simuler toutes les trajectoires, stocker, relire »: la même politique est
+// rejouée sur une matrice complète (PathSet de M trajectoires, mêmes tirages).
+template <typename Payoff>
+MonteCarloResult stored_paths_payoff(const HestonParams& p, int N, long M, const Payoff& payoff,
+                                     uint64_t seed) {
+    Payoff local = payoff;
+    PathSet paths(N, M);
+    simulate_paths_block(p, N, seed, 0, M, paths.stock(0), paths.variance(0), paths.stride());
+    local.start(p, N, M);
+    for (int i = 1; i <= N; ++i) {
+        local.observe(i, M, paths.stock(i), paths.variance(i));
+    }
+    RunningStats total;
+    for (long m = 0; m < M; ++m) {
+        total.add(local.value(m));
+    }
+    return make_result(total);
+}
+
+// Débit des politiques de payoff évaluées dans la boucle de pas, contre stockage des
+// trajectoires puis seconde passe (mêmes tirages: prix identiques aux arrondis près, la
+// réduction se faisant par blocs d'un côté et d'un seul tenant de l'autre).
+void bench_payoffs() {
+    const HestonParams& p = kParams;
+    const double K = kStrike;
+    const int N = 252;
+    const long M = 100000, block = 2048;
+    const double discount = exp(-p.drift * p.T);
+
+    printf("Payoffs exotiques (Euler, N = %d, M = %ld, 1 thread); matrice stockée: %.0f Mo\n",
+           N, M, 2.0 * (N + 1) * M * sizeof(double) / 1e6);
+    printf("%-14s %10s %9s %14s %14s %s\n", "payoff", "prix", "erreur", "en ligne Mt/s",
+           "stockés Mt/s", "");
+    auto run = [&](const char* name, const auto& payoff) {
+        auto start = chrono::steady_clock::now();
+        MonteCarloResult inline_result = heston_mc_payoff(p, N, M, payoff, 42, 1, block);
+        const double t_inline = seconds_since(start);
+        start = chrono::steady_clock::now();
+        MonteCarloResult stored = stored_paths_payoff(p, N, M, payoff, 42);
+        const double t_stored = seconds_since(start);
+        printf("%-14s %10.5f %9.5f %14.3f %14.3f %s\n", name,
+               discount * inline_result.estimate, discount * inline_result.std_error,
+               M / t_inline / 1e6, M / t_stored / 1e6,
+               fabs(inline_result.estimate - stored.estimate) < 1e-9 ? "" : "(écart!)");
+    };
+    run("asiatique", ArithmeticAsianCall(K));
+    run("up-and-out", BarrierCall<BarrierType::UpAndOut>(K, 130.0));
+    run("down-and-out", BarrierCall<BarrierType::DownAndOut>(K, 85.0));
+    run("lookback", FloatingLookbackCall());
+    run("cliquet", Cliquet(12, -0.02, 0.03, 0.0));
+    printf("\n");
+}
+
+// Stockage aux seules dates d'observation (mensuelles) contre la matrice complète des pas
+// quotidiens: mémoire, temps, et égalité des valeurs aux dates communes.
+void bench_observed() {
+    const HestonParams& p = kParams;
+    const int N = 252;
+    const long M = 100000;
+    vector<double> months;
+    for (int k = 1; k <= 12; ++k) {
+        months.push_back(k / 12.0);
+    }
+    const vector<int> steps = observation_steps(p, N, months);
+
+    auto start = chrono::steady_clock::now();
+    ObservedPaths observed = simulate_observed(p, N, M, steps, 42);
+    const double t_observed = seconds_since(start);
+    start = chrono::steady_clock::now();
+    PathSet full(N, M);
+    simulate_paths_block(p, N, 42, 0, M, full.stock(0), full.variance(0), full.stride());
+    const double t_full = seconds_since(start);
+
+    long mismatches = 0;
+    for (size_t k = 0; k < steps.size(); ++k) {
+        const double* a = observed.paths.stock(static_cast<int>(k) + 1);
+        const double* b = full.stock(steps[k]);
+        for (long m = 0; m < M; ++m) {
+            mismatches += a[m] != b[m];
+        }
+    }
+    auto megabytes = [](const PathSet& set) {
+        return 2.0 * set.dates() * set.stride() * sizeof(double) / 1e6;
+    };
+    printf("Dates d'observation (Euler, N = %d, M = %ld, %zu dates)\n", N, M, steps.size());
+    printf("matrice complète: %7.1f Mo, %.2fs\n", megabytes(full), t_full);
+    printf("dates observées:  %7.1f Mo, %.2fs\n", megabytes(observed.paths), t_observed);
+    printf("valeurs différentes aux dates communes: %ld\n\n", mismatches);
+}
+
+// Panier et worst-of sur d actifs de Heston (sous-jacents équicorrélés à 0,5, paramètres
+// légèrement différents par actif): prix, débit, et part du temps passée dans L z.
+void bench_basket() {
+    const int N = 50;
+    const long M = 20000;
+    printf("Multi-actifs (Euler, N = %d, M = %ld)\n", N, M);
+    printf("%4s %12s %9s %12s %9s %9s %10s\n", "d", "panier", "erreur", "worst-of", "erreur",
+           "temps", "L z");
+    for (int d : {10, 50}) {
+        vector<HestonParams> assets;
+        for (int j = 0; j < d; ++j) {
+            HestonParams q = kParams;
+            q.v0 = 0.03 + 0.02 * j / d;
+            q.rho = -0.5 - 0.3 * j / d;
+            assets.push_back(q);
+        }
+        vector<double> spot(d * d, 0.5);
+        for (int j = 0; j < d; ++j) {
+            spot[j * d + j] = 1.0;
+        }
+        MultiAssetHeston model(assets, heston_correlation(assets, spot));
+        const double discount = exp(-kParams.drift * kParams.T);
+
+        auto start = chrono::steady_clock::now();
+        MonteCarloResult basket =
+            heston_multi_asset_mc(model, N, M, BasketCall{vector<double>(d, 1.0 / d), 1.0}, 42);
+        MonteCarloResult worst = heston_multi_asset_mc(model, N, M, WorstOfCall{0.8}, 42);
+        const double elapsed = seconds_since(start);
+
+        // Coût seul de l'application de L, sur le même volume (2 passes x N pas x M).
+        const long n = 512;
+        vector<double> z(2 * d * n, 0.5), w(2 * d * n);
+        start = chrono::steady_clock::now();
+        for (long rep = 0; rep < 2 * N * (M / n); ++rep) {
+            model.correlate(n, z.data(), w.data());
+        }
+        const double t_correlate = seconds_since(start);
+        printf("%4d %12.5f %9.5f %12.5f %9.5f %8.2fs %9.0f%%\n", d,
+               kParams.S0 * discount * basket.estimate, kParams.S0 * discount * basket.std_error,
+               kParams.S0 * discount * worst.estimate, kParams.S0 * discount * worst.std_error,
+               elapsed, 100 * t_correlate / elapsed);
+    }
+    printf("(prix pour un nominal S0 = %.0f)\n\n", kParams.S0);
+}
+
+// Moteur float32 contre moteur double (mêmes uniformes Philox, un thread): débit, biais du
+// prix et écart trajectoriel de S_T, puis précision des sommes de payoffs en float.
+void bench_f32() {
+    const HestonParams& p = kParams;
+    const double K = kStrike;
+    const int N = 100;
+    const long M = 400000;
+    auto call = [K](double ST) { return ST > K ? ST - K : 0.0; };
+
+    auto start = chrono::steady_clock::now();
+    MonteCarloResult ref = heston_mc_parallel(p, N, M, call, 42, 1);
+    const double t_double = seconds_since(start);
+    start = chrono::steady_clock::now();
+    MonteCarloResult single = heston_mc_f32(p, N, M, call, 42, 1);
+    const double t_float = seconds_since(start);
+    MonteCarloResult kahan = heston_mc_f32(p, N, M, call, 42, 1, 2048, Accumulator::Kahan);
+
+    // Écart trajectoriel sur un bloc.
+    const long n = 2048;
+    vector<double> S(n), v(n);
+    vector<float> Sf(n), vf(n);
+    simulate_block(p, N, 42, 0, n, S.data(), v.data());
+    simulate_block_f32(p, N, 42, 0, n, Sf.data(), vf.data());
+    double max_rel = 0;
+    for (long m = 0; m < n; ++m) {
+        max_rel = max(max_rel, fabs(Sf[m] - S[m]) / S[m]);
+    }
+
+    printf("Moteur float32 (Euler, N = %d, M = %ld, 1 thread)\n", N, M);
+    printf("double:  %.6f +- %.6f  %.2fs (%.2f Mt/s)\n", ref.estimate, ref.std_error, t_double,
+           M / t_double / 1e6);
+    printf("float32: %.6f +- %.6f  %.2fs (%.2f Mt/s), gain x%.2f\n", single.estimate,
+           single.std_error, t_float, M / t_float / 1e6, t_double / t_float);
+    printf("biais float32 - double: %.2e (%.4f erreur type), Kahan float: %.2e\n",
+           single.estimate - ref.estimate, (single.estimate - ref.estimate) / ref.std_error,
+           kahan.estimate - ref.estimate);
+    printf("écart relatif max de S_T sur %ld trajectoires: %.2e\n", n, max_rel);
+
+    // Erreur type des sommes de Kahan en float quand la moyenne domine l'écart type: payoff
+    // décalé de 1e5, dont la somme des carrés bruts perdrait toute la variance.
+    auto shifted = [&call](double ST) { return 1e5 + call(ST); };
+    MonteCarloResult wide = heston_mc_f32(p, N, M, shifted, 42, 1);
+    MonteCarloResult wide_kahan = heston_mc_f32(p, N, M, shifted, 42, 1, 2048, Accumulator::Kahan);
+    printf("erreur type, payoff + 1e5: RunningStats %.6f, Kahan float %.6f (call seul %.6f)\n",
+           wide.std_error, wide_kahan.std_error, single.std_error);
+
+    // Sommes d'un grand nombre de payoffs float32: naïve en float, Kahan en float, double.
+    const long count = 1L << 24;
+    float naive = 0;
+    KahanSum<float> compensated;
+    double exact = 0;
+    for (long m = 0; m < count; ++m) {
+        const float x = static_cast<float>(call(Sf[m % n]));
+        naive += x;
+        compensated.add(x);
+        exact += x;
+    }
+    printf("moyenne de %ld payoffs: float naïf %.6f, Kahan float %.6f, double %.6f\n\n", count,
+           naive / count, compensated.sum() / count, exact / count);
+}
+
+// Politiques de placement NUMA: threads libres et buffers sur le noeud du thread appelant,
+// threads fixés, ou threads fixés par noeud avec première écriture locale et réduction
+// hiérarchique. NUMA_PLACEMENT (make bench PLACEMENT=...) n'en garde qu'une.
+void bench_numa() {
+    const HestonParams& p = kParams;
+    const double K = kStrike;
+    const int N = 100;
+    const long M = 400000;
+    auto call = [K](double ST) { return ST > K ? ST - K : 0.0; };
+    const NumaTopology topology = NumaTopology::detect();
+    printf("Placement NUMA (Euler, N = %d, M = %ld): %d noeud(s), %d CPU\n", N, M,
+           topology.nodes(), topology.cpus());
+    for (int k = 0; k < topology.nodes(); ++k) {
+        printf("  noeud %d: %zu CPU\n", k, topology.node_cpus[k].size());
+    }
+
+    const char* only = getenv("NUMA_PLACEMENT");
+    const struct {
+        const char* name;
+        NumaPlacement placement;
+    } policies[] = {{"naive", NumaPlacement::Naive},
+                    {"pinned", NumaPlacement::Pinned},
+                    {"numa-local", NumaPlacement::NumaLocal}};
+    MonteCarloResult flat = heston_mc_parallel(p, N, M, call, 42);
+    for (const auto& policy : policies) {
+        if (only && *only && strcmp(only, policy.name) != 0) {
+            continue;
+        }
+        auto start = chrono::steady_clock::now();
+        MonteCarloResult r = heston_mc_numa(p, N, M, call, 42, policy.placement, topology);
+        const double elapsed = seconds_since(start);
+        printf("%-11s %.2fs (%.2f Mt/s)  prix %.10f, écart à heston_mc_parallel %.1e\n",
+               policy.name, elapsed, M / elapsed / 1e6, r.estimate, r.estimate - flat.estimate);
+    }
+    printf("\n");
+}
+
+// Générateur de marché synthétique: débit (symboles par seconde) et contrôles de cohérence
+// des historiques (variance réalisée des rendements contre variance simulée) et des chaînes.
+void bench_market() {
+    SyntheticMarketConfig config;
+    config.symbols = 200;
+    auto start = chrono::steady_clock::now();
+    vector<SyntheticSymbol> market = generate_synthetic_market(config);
+    const double elapsed = seconds_since(start);
+    const size_t quotes = market.front().chain.size();
+
+    RunningStats variance_gap, noise;
+    for (const SyntheticSymbol& s : market) {
+        double realized = 0, simulated = 0;
+        for (int i = 1; i <= config.days; ++i) {
+            const double r = log(s.bars[i].adjustedClose / s.bars[i - 1].adjustedClose);
+            realized += r * r;
+            simulated += s.variance[i - 1] / 252;
+        }
+        variance_gap.add(realized / simulated - 1);
+        for (const SyntheticQuote& q : s.chain) {
+            const double sd = config.relative_noise * q.model_price + config.absolute_noise;
+            noise.add((q.price - q.model_price) / sd);
+        }
+    }
+    const SyntheticSymbol& first = market.front();
+    printf("Marché synthétique: %d symboles x %d jours, %zu options par chaîne\n",
+           config.symbols, config.days, quotes);
+    printf("génération: %.2fs (%.0f symboles/s)\n", elapsed, config.symbols / elapsed);
+    printf("variance réalisée / simulée - 1: %.4f +- %.4f\n", variance_gap.mean(),
+           variance_gap.std_error());
+    printf("bruit des prix réduit: moyenne %.4f, écart type %.4f (0 et 1 hors troncature à 0)\n",
+           noise.mean(), sqrt(noise.variance()));
+    printf("%s: kappa %.3f theta %.4f sigma %.3f rho %.3f v0 %.4f, %s %.2f ... %s %.2f\n\n",
+           first.symbol.c_str(), first.params.kappa, first.params.theta, first.params.sigma,
+           first.params.rho, first.params.v0, first.bars.front().date.c_str(),
+           first.bars.front().adjustedClose, first.bars.back().date.c_str(),
+           first.bars.back().adjustedClose);
+}
+
+// Ajustement de (v0, kappa, theta, sigma, rho) à une chaîne synthétique par
+// Levenberg-Marquardt: résidus réduits par l'écart type du bruit de cotation, jacobien par
+// différences avant, prix de HestonBatchPricer. Le calibrateur du projet (nlopt,
+// vraisemblance des historiques) n'est pas lié aux bancs d'essai.
+struct ChainFit {
+    double x[5];  // v0, kappa, theta, sigma, rho
+    double chi2;
+    int iterations;
+    int evaluations;
+};
+
+ChainFit calibrate_chain(const SyntheticSymbol& s, const SyntheticMarketConfig& config) {
+    const int P = 5;
+    const double lower[P] = {1e-4, 0.05, 1e-3, 0.05, -0.99};
+    const double upper[P] = {1.0, 10.0, 1.0, 2.0, 0.99};
+    const double S = s.bars.back().adjustedClose;
+    const size_t n = s.chain.size();
+    vector<BatchContract> contracts(n);
+    vector<double> sd(n);
+    for (size_t k = 0; k < n; ++k) {
+        contracts[k] = s.chain[k].contract;
+        sd[k] = config.relative_noise * s.chain[k].price + config.absolute_noise;
+    }
+    ChainFit fit{{0.04, 2.0, 0.04, 0.5, -0.5}, 0, 0, 0};
+    auto residuals = [&](const double* x, vector<double>& r) {
+        HestonBatchPricer pricer(S, x[0], x[1], x[2], x[3], x[4], s.params.drift);
+        pricer.du = 0.02;  // u_max = 200: les intégrandes à un mois décroissent lentement
+        const vector<double> model = pricer.price(contracts);
+        double chi2 = 0;
+        for (size_t k = 0; k < n; ++k) {
+            r[k] = (model[k] - s.chain[k].price) / sd[k];
+            chi2 += r[k] * r[k];
+        }
+        ++fit.evaluations;
+        return chi2;
+    };
+
+    vector<double> r(n), trial(n);
+    vector<vector<double>> J(P, vector<double>(n));
+    fit.chi2 = residuals(fit.x, r);
+    double lambda = 1e-3;
+    for (fit.iterations = 0; fit.iterations < 100; ++fit.iterations) {
+        for (int j = 0; j < P; ++j) {
+            double x[P];
+            copy(fit.x, fit.x + P, x);
+            const double h = (fit.x[j] + 1e-6 <= upper[j] ? 1e-6 : -1e-6) * max(1.0, fabs(x[j]));
+            x[j] += h;
+            residuals(x, J[j]);
+            for (size_t k = 0; k < n; ++k) {
+                J[j][k] = (J[j][k] - r[k]) / h;
+            }
+        }
+        vector<double> A(P * P), g(P);
+        for (int i = 0; i < P; ++i) {
+            for (size_t k = 0; k < n; ++k) {
+                g[i] -= J[i][k] * r[k];
+            }
+            for (int j = 0; j < P; ++j) {
+                for (size_t k = 0; k < n; ++k) {
+                    A[i * P + j] += J[i][k] * J[j][k];
+                }
+            }
+        }
+        bool accepted = false;
+        double previous = fit.chi2;
+        while (!accepted && lambda < 1e10) {
+            vector<double> damped = A;
+            for (int i = 0; i < P; ++i) {
+                damped[i * P + i] *= 1 + lambda;
+            }
+            const vector<double> step = solve_normal_equations(damped, g, P);
+            double x[P];
+            for (int i = 0; i < P; ++i) {
+                x[i] = min(upper[i], max(lower[i], fit.x[i] + step[i]));
+            }
+            const double chi2 = residuals(x, trial);
+            if (chi2 < fit.chi2) {
+                copy(x, x + P, fit.x);
+                fit.chi2 = chi2;
+                r.swap(trial);
+                lambda = max(1e-7, lambda / 10);
+                accepted = true;
+            } else {
+                lambda *= 10;
+            }
+        }
+        if (!accepted || previous - fit.chi2 < 1e-8 * previous) {
+            break;
+        }
+    }
+    return fit;
+}
+
+// Calibration sur le marché synthétique: paramètres retrouvés à partir des chaînes bruitées
+// (36 options hors de la monnaie par symbole) contre les paramètres vrais, et temps par
+// symbole. v0 est comparé à la variance du dernier jour, état auquel la chaîne est cotée.
+void bench_calibration() {
+    SyntheticMarketConfig config;
+    config.symbols = 8;
+    const vector<SyntheticSymbol> market = generate_synthetic_market(config);
+    printf("Calibration Levenberg-Marquardt sur %d chaînes synthétiques (paramètres vrais / "
+           "ajustés)\n", config.symbols);
+    printf("%-9s %15s %17s %15s %15s %17s %6s %5s %7s\n", "symbole", "v0", "kappa", "theta",
+           "sigma", "rho", "chi2/n", "éval", "temps");
+    RunningStats errors[5], seconds;
+    for (const SyntheticSymbol& s : market) {
+        auto start = chrono::steady_clock::now();
+        const ChainFit fit = calibrate_chain(s, config);
+        const double elapsed = seconds_since(start);
+        seconds.add(elapsed);
+        const HestonParams& p = s.params;
+        const double truth[5] = {s.variance.back(), p.kappa, p.theta, p.sigma, p.rho};
+        printf("%-9s", s.symbol.c_str());
+        for (int i = 0; i < 5; ++i) {
+            printf(i == 1 || i == 4 ? " %8.4f/%-8.4f" : " %7.4f/%-7.4f", truth[i], fit.x[i]);
+            errors[i].add(fabs(fit.x[i] - truth[i]));
+        }
+        printf(" %6.2f %5d %6.2fs\n", fit.chi2 / s.chain.size(), fit.evaluations, elapsed);
+    }
+    printf("erreur absolue moyenne: v0 %.4f, kappa %.3f, theta %.4f, sigma %.3f, rho %.3f\n",
+           errors[0].mean(), errors[1].mean(), errors[2].mean(), errors[3].mean(),
+           errors[4].mean());
+    printf("temps moyen par symbole: %.2fs\n\n", seconds.mean());
+}
+
+// Heston-SLV: calibration particulaire du levier sur une volatilité locale plate de 20 %
+// (binning et noyau), puis prix de calls par Monte Carlo hors échantillon. Les calls du
+// modèle calibré doivent retrouver Black-Scholes à 20 % sur tous les strikes, là où Heston
+// seul produit un smile.
+void bench_slv() {
+    const HestonParams& p = kParams;
+    const double vol = 0.2;
+    const long M = 200000;
+    auto flat = [vol](double, double) { return vol; };
+    auto bs = [&](double T, double K) { return black_scholes_call(p.S0, K, T, vol, p.drift); };
+    printf("Heston-SLV, volatilité locale plate %.0f %% (Dupire sur Black-Scholes: %.6f)\n",
+           100 * vol, dupire_local_vol(bs, p.drift, 0.5, 110.0));
+
+    const struct {
+        const char* name;
+        SlvConfig::Regression regression;
+    } methods[] = {{"binning", SlvConfig::Regression::Binning},
+                   {"noyau", SlvConfig::Regression::Kernel}};
+    vector<LeverageFunction> leverages;
+    SlvConfig config;
+    for (const auto& method : methods) {
+        config.regression = method.regression;
+        auto start = chrono::steady_clock::now();
+        leverages.push_back(calibrate_leverage(p, flat, config));
+        const double elapsed = seconds_since(start);
+        printf("calibration %-7s: %d pas x %ld particules, %.2fs\n", method.name, config.steps,
+               config.particles, elapsed);
+    }
+
+    printf("%6s %10s %22s %22s %22s\n", "K", "BS", "Heston (vol)", "SLV binning (vol)",
+           "SLV noyau (vol)");
+    const double discount = exp(-p.drift * p.T);
+    for (double K : {80.0, 90.0, 100.0, 110.0, 120.0}) {
+        auto call = [K](double ST) { return ST > K ? ST - K : 0.0; };
+        const double target = black_scholes_call(p.S0, K, p.T, vol, p.drift);
+        const double d1 = (log(p.S0 / K) + (p.drift + 0.5 * vol * vol) * p.T) / (vol * sqrt(p.T));
+        const double vega = p.S0 * norm_pdf(d1) * sqrt(p.T);
+        printf("%6.0f %10.4f", K, target);
+        const MonteCarloResult heston = heston_mc_parallel(p, config.steps, M, call, 7);
+        printf(" %10.4f (%+.2f%%)", discount * heston.estimate,
+               100 * (discount * heston.estimate - target) / vega);
+        for (const LeverageFunction& leverage : leverages) {
+            const MonteCarloResult r = heston_slv_mc(p, leverage, M, call, 7);
+            printf(" %10.4f (%+.2f%%)", discount * r.estimate,
+                   100 * (discount * r.estimate - target) / vega);
+        }
+        printf("\n");
+    }
+    printf("(écart de volatilité implicite ~ écart de prix / vega; erreur type ~ 0,05 %%)\n\n");
+}
+
+// Put bermudéen à pas de temps de l'arbre binomial CRR de Black-Scholes, exercice permis
+// tous les steps_per_date pas: référence de l'LSM quand sigma (vol de la variance) tend vers 0.
+double crr_bermudan_put(double S0, double K, double T, double vol, double r, int dates,
+                        int steps_per_date) {
+    const int n = dates * steps_per_date;
+    const double dt = T / n;
+    const double u = exp(vol * sqrt(dt)), d = 1 / u;
+    const double q = (exp(r * dt) - d) / (u - d), discount = exp(-r * dt);
+    vector<double> value(n + 1);
+    for (int j = 0; j <= n; ++j) {
+        value[j] = max(K - S0 * pow(u, 2 * j - n), 0.0);
+    }
+    for (int i = n - 1; i >= 0; --i) {
+        for (int j = 0; j <= i; ++j) {
+            value[j] = discount * (q * value[j + 1] + (1 - q) * value[j]);
+            if (i > 0 && i % steps_per_date == 0) {
+                value[j] = max(value[j], K - S0 * pow(u, 2 * j - i));
+            }
+        }
+    }
+    return value[0];
+}
+
+// Longstaff-Schwartz: put bermudéen à 50 dates. Contrôle contre l'arbre binomial quand la
+// variance est quasi constante, puis sous Heston: borne haute (dans l'échantillon) et borne
+// basse (règle appliquée à des trajectoires indépendantes, sans stockage) selon le degré de
+// la base, et mémoire des seules dates d'exercice contre la matrice complète.
+void bench_lsm() {
+    const int N = 200;
+    const long M = 100000;
+    const double K = kStrike;
+    auto put = [K](double S) { return S < K ? K - S : 0.0; };
+    vector<double> dates;
+    for (int k = 1; k <= 50; ++k) {
+        dates.push_back(k / 50.0);
+    }
+    printf("Longstaff-Schwartz (Euler, N = %d, M = %ld, %zu dates d'exercice)\n", N, M,
+           dates.size());
+
+    HestonParams flat = kParams;
+    flat.sigma = 1e-4;
+    flat.v0 = flat.theta;
+    const double tree = crr_bermudan_put(flat.S0, K, flat.T, sqrt(flat.theta), flat.drift, 50, 40);
+    LsmResult lsm = heston_lsm(flat, N, M, dates, put, 42);
+    const vector<int> steps = observation_steps(flat, N, dates);
+    MonteCarloResult low =
+        heston_mc_payoff(flat, N, M, LsmExercise<decltype(put)>(lsm.policy, steps, put), 43);
+    printf("variance constante: arbre %.4f, LSM %.4f +- %.4f (haut) / %.4f +- %.4f (bas)\n",
+           tree, lsm.price.estimate, lsm.price.std_error, low.estimate, low.std_error);
+
+    // Prime d'exercice anticipé mesurée contre le put européen des mêmes trajectoires: le
+    // bruit commun s'annule et les bornes haute et basse deviennent comparables.
+    const HestonParams& p = kParams;
+    HestonPricer pricer(p.S0, K, p.T, p.v0, p.kappa, p.theta, p.sigma, p.rho, p.drift);
+    const double european = pricer.price_put_within(chrono::steady_clock::time_point::max()).price;
+    const double discount = exp(-p.drift * p.T);
+    const double in_sample = discount * heston_mc_parallel(p, N, M, put, 42).estimate;
+    const double out_sample = discount * heston_mc_parallel(p, N, M, put, 43).estimate;
+    printf("Heston, put européen: Fourier %.4f, Euler %.4f / %.4f (graines 42 / 43)\n", european,
+           in_sample, out_sample);
+    printf("%6s %18s %18s %8s %8s %10s %8s\n", "degré", "haut", "bas", "prime h", "prime b",
+           "exercice", "temps");
+    for (int degree : {1, 2, 3, 4}) {
+        LsmConfig config;
+        config.degree = degree;
+        auto start = chrono::steady_clock::now();
+        LsmResult r = heston_lsm(p, N, M, dates, put, 42, config);
+        const double elapsed = seconds_since(start);
+        MonteCarloResult out =
+            heston_mc_payoff(p, N, M, LsmExercise<decltype(put)>(r.policy, steps, put), 43);
+        printf("%6d %9.4f +- %.4f %9.4f +- %.4f %8.4f %8.4f %9.1f%% %7.2fs\n", degree,
+               r.price.estimate, r.price.std_error, out.estimate, out.std_error,
+               r.price.estimate - in_sample, out.estimate - out_sample,
+               100 * r.exercise_fraction, elapsed);
+    }
+    const double dates_mb = 2.0 * (dates.size() + 1) * M * sizeof(double) / 1e6;
+    const double full_mb = 2.0 * (N + 1) * M * sizeof(double) / 1e6;
+    printf("trajectoires stockées: %.1f Mo (dates d'exercice) au lieu de %.1f Mo\n\n", dates_mb,
+           full_mb);
+}
+
+struct Benchmark {
+    const char* name;
+    function<void()> run;
+};
+
+}  // namespace
+
+// Usage: heston_bench [nom...]; sans argument, tous les bancs sont exécutés.
+int main(int argc, char** argv) {
+    const vector<Benchmark> benchmarks = {
+        {"mixed", bench_mixed},
+        {"distribution", bench_distribution},
+        {"pde", bench_pde},
+        {"deadline", bench_deadline},
+        {"asymptotic", bench_asymptotic},
+        {"scheme", bench_scheme_bias},
+        {"exact", bench_exact_sampling},
+        {"determinism", bench_determinism},
+        {"qmc", bench_qmc},
+        {"variance", bench_variance_reduction},
+        {"mlmc", bench_mlmc},
+        {"greeks", bench_greeks},
+        {"archive", bench_path_archive},
+        {"adaptive", bench_adaptive},
+        {"payoffs", bench_payoffs},
+        {"observed", bench_observed},
+        {"basket", bench_basket},
+        {"f32", bench_f32},
+        {"numa", bench_numa},
+        {"market", bench_market},
+        {"calibration", bench_calibration},
+        {"slv", bench_slv},
+        {"lsm", bench_lsm},
+    };
+    for (const Benchmark& b : benchmarks) {
+        bool selected = argc == 1;
+        for (int i = 1; i < argc; ++i) {
+            selected = selected || strcmp(argv[i], b.name) == 0;
+        }
+        if (selected) {
+            b.run();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include "exactSampling.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "philox.h"
+
+using namespace std;
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+// Gamma(shape, 1) par Marsaglia-Tsang; shape < 1 se ramène à shape + 1.
+double sample_gamma(PhiloxStream& rng, double shape) {
+    if (shape < 1) {
+        double u = rng.uniform();
+        return sample_gamma(rng, shape + 1) * pow(u, 1 / shape);
+    }
+    const double d = shape - 1.0 / 3;
+    const double c = 1 / sqrt(9 * d);
+    for (;;) {
+        double z = rng.normal();
+        double x = 1 + c * z;
+        if (x <= 0) {
+            continue;
+        }
+        x = x * x * x;
+        if (log(rng.uniform()) < 0.5 * z * z + d - d * x + d * log(x)) {
+            return d * x;
+        }
+    }
+}
+
+// Poisson par inversion séquentielle; approximation gaussienne pour les grandes moyennes
+// (exp(-mean) sous-déborde au-delà de ~700).
+long sample_poisson(PhiloxStream& rng, double mean) {
+    if (mean > 500) {
+        return max(0L, lround(mean + sqrt(mean) * rng.normal()));
+    }
+    const double u = rng.uniform();
+    double prob = exp(-mean), cdf = prob;
+    long k = 0;
+    while (u > cdf) {
+        ++k;
+        prob *= mean / k;
+        cdf += prob;
+        if (k > mean && prob < 1e-300) {
+            break;
+        }
+    }
+    return k;
+}
+
+// Loi de Bessel(nu, z): P(n) proportionnelle à (z/2)^(2n) / (n! Gamma(n + nu + 1)), inversée
+// sur les termes non normalisés. Au-delà de z ~ 600 (maturités très courtes) les termes
+// débordent et on utilise l'approximation gaussienne de moyenne z/2 et de variance z/4.
+long sample_bessel(PhiloxStream& rng, double nu, double z) {
+    if (z > 600) {
+        return max(0L, lround(0.5 * z - 0.25 * (2 * nu + 1) + 0.5 * sqrt(z) * rng.normal()));
+    }
+    const double q = 0.25 * z * z;
+    double term = 1, total = 1;
+    for (long n = 1;; ++n) {
+        term *= q / (n * (n + nu));
+        total += term;
+        if (n * (n + nu) > q && term < 1e-17 * total) {
+            break;
+        }
+    }
+    const double target = rng.uniform() * total;
+    double cdf = 1;
+    long n = 0;
+    term = 1;
+    while (cdf < target) {
+        ++n;
+        term *= q / (n * (n + nu));
+        cdf += term;
+    }
+    return n;
+}
+
+}  // namespace
+
+GammaExpansionMoments gamma_expansion_moments(double kappa, double sigma, double T) {
+    const double x = 0.5 * kappa * T;
+    const double coth = 1 / tanh(x);
+    const double csch2 = 1 / (sinh(x) * sinh(x));
+    const double s2 = sigma * sigma;
+    GammaExpansionMoments m;
+    m.mean_x1 = coth / kappa - 0.5 * T * csch2;
+    m.var_x1 = s2 / (kappa * kappa * kappa) * coth + s2 * T / (2 * kappa * kappa) * csch2 -
+               s2 * T * T / (2 * kappa) * coth * csch2;
+    m.mean_x2 = s2 / (4 * kappa * kappa) * (-2 + kappa * T * coth);
+    m.var_x2 = s2 * s2 / (8 * kappa * kappa * kappa * kappa) *
+               (-8 + 2 * kappa * T * coth + kappa * kappa * T * T * csch2);
+    return m;
+}
+
+void exact_terminal(const HestonParams& p, uint64_t seed, long first_path, long n, double* S,
+                    double* v, int terms) {
+    const double s2 = p.sigma * p.sigma;
+    const double e = exp(-p.kappa * p.T);
+    // vT = c * khi-deux(delta, lambda)
+    const double c = s2 * (1 - e) / (4 * p.kappa);
+    const double delta = 4 * p.kappa * p.theta / s2;
+    const double lambda = p.v0 * e / c;
+    const double nu = 0.5 * delta - 1;
+    const double bessel_scale = 2 * p.kappa / (s2 * sinh(0.5 * p.kappa * p.T));
+    const double rho_bar = sqrt(1 - p.rho * p.rho);
+    const double log_S0 = log(p.S0) + p.drift * p.T;
+
+    // Termes n = 1..terms de la série tirés exactement: taux gamma_n et intensités de
+    // Poisson par unité de (v0 + vT); le reste est une gamma de mêmes deux premiers moments.
+    vector<double> gamma_n(terms), rate_n(terms);
+    GammaExpansionMoments tail = gamma_expansion_moments(p.kappa, p.sigma, p.T);
+    const double kT2 = p.kappa * p.kappa * p.T * p.T;
+    for (int k = 0; k < terms; ++k) {
+        double a = 4 * PI * PI * (k + 1) * (k + 1);
+        gamma_n[k] = (kT2 + a) / (2 * s2 * p.T * p.T);
+        rate_n[k] = 4 * a / (s2 * p.T * (kT2 + a));
+        tail.mean_x1 -= rate_n[k] / gamma_n[k];
+        tail.var_x1 -= 2 * rate_n[k] / (gamma_n[k] * gamma_n[k]);
+        tail.mean_x2 -= 0.5 / gamma_n[k];
+        tail.var_x2 -= 0.5 / (gamma_n[k] * gamma_n[k]);
+    }
+
+    for (long m = 0; m < n; ++m) {
+        PhiloxStream rng(seed, static_cast<uint64_t>(first_path + m), STREAM_EXACT);
+        long poisson = sample_poisson(rng, 0.5 * lambda);
+        double vT = 2 * c * sample_gamma(rng, 0.5 * delta + poisson);
+        long eta = sample_bessel(rng, nu, bessel_scale * sqrt(p.v0 * vT));
+
+        // IV = X1 + X2 + X3, X3 = somme de eta copies de Z (gamma de forme 2 par terme).
+        const double shape = 0.5 * delta + 2 * eta;
+        double iv = 0;
+        for (int k = 0; k < terms; ++k) {
+            long jumps = sample_poisson(rng, (p.v0 + vT) * rate_n[k]);
+            double g = jumps > 0 ? sample_gamma(rng, static_cast<double>(jumps)) : 0.0;
+            iv += (g + sample_gamma(rng, shape)) / gamma_n[k];
+        }
+        double mean = (p.v0 + vT) * tail.mean_x1 + (delta + 4 * eta) * tail.mean_x2;
+        double var = (p.v0 + vT) * tail.var_x1 + (delta + 4 * eta) * tail.var_x2;
+        if (mean > 0 && var > 0) {
+            iv += var / mean * sample_gamma(rng, mean * mean / var);
+        }
+
+        double log_S = log_S0 + p.rho / p.sigma * (vT - p.v0 - p.kappa * p.theta * p.T) +
+                       (p.kappa * p.rho / p.sigma - 0.5) * iv + rho_bar * sqrt(iv) * rng.normal();
+        S[m] = exp(log_S);
+        v[m] = vT;
+    }
+}
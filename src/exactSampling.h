@@ -0,0 +1,27 @@
+#ifndef EXACT_SAMPLING_H
+#define EXACT_SAMPLING_H
+
+#include <cstdint>
+#include "monteCarlo.h"
+
+// Moments de la décomposition de Glasserman-Kim (2011) de l'intégrale de variance
+// conditionnelle à (v0, vT): IV = X1 + X2 + sum_{j<=eta} Z_j. Les moments de X1 sont par unité
+// de (v0 + vT), ceux de X2 par unité de delta = 4 kappa theta / sigma^2; E[Z] = 4 mean_x2.
+struct GammaExpansionMoments {
+    double mean_x1;
+    double var_x1;
+    double mean_x2;
+    double var_x2;
+};
+
+GammaExpansionMoments gamma_expansion_moments(double kappa, double sigma, double T);
+
+// Échantillonnage presque exact des valeurs terminales pour les trajectoires
+// [first_path, first_path + n): vT exacte (khi-deux non centré, mélange de Poisson), puis IV
+// par l'expansion gamma de Glasserman-Kim tronquée à terms termes, le reste étant remplacé
+// par une gamma de mêmes deux premiers moments; ln S_T est alors gaussien (Broadie-Kaya).
+// Coût O(terms) par trajectoire, indépendant de la maturité: pas de pas de temps.
+void exact_terminal(const HestonParams& p, std::uint64_t seed, long first_path, long n, double* S,
+                    double* v, int terms = 10);
+
+#endif // EXACT_SAMPLING_H
@@ -0,0 +1,68 @@
+#include "longstaffSchwartz.h"
+#include <cmath>
+
+using namespace std;
+
+namespace {
+
+// Régularisations relatives successives tentées quand la factorisation échoue.
+constexpr double kRidgeSteps[] = {0.0, 1e-12, 1e-9, 1e-6, 1e-3};
+
+// Cholesky en place du triangle inférieur de a; faux si a n'est pas définie positive.
+bool cholesky_in_place(vector<double>& a, int n) {
+    for (int j = 0; j < n; ++j) {
+        double d = a[j * n + j];
+        for (int k = 0; k < j; ++k) {
+            d -= a[j * n + k] * a[j * n + k];
+        }
+        if (!(d > 0)) {
+            return false;
+        }
+        a[j * n + j] = sqrt(d);
+        for (int i = j + 1; i < n; ++i) {
+            double s = a[i * n + j];
+            for (int k = 0; k < j; ++k) {
+                s -= a[i * n + k] * a[j * n + k];
+            }
+            a[i * n + j] = s / a[j * n + j];
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+vector<double> solve_normal_equations(vector<double> gram, vector<double> rhs, int n) {
+    double scale = 0;
+    for (int i = 0; i < n; ++i) {
+        scale = max(scale, gram[i * n + i]);
+    }
+    vector<double> factor;
+    for (double ridge : kRidgeSteps) {
+        factor = gram;
+        for (int i = 0; i < n; ++i) {
+            factor[i * n + i] += ridge * scale;
+        }
+        if (cholesky_in_place(factor, n)) {
+            break;
+        }
+        factor.clear();
+    }
+    if (factor.empty()) {
+        return vector<double>(n, 0.0);  // matrice nulle: continuation nulle
+    }
+    // L y = r puis L^T beta = y.
+    for (int i = 0; i < n; ++i) {
+        for (int k = 0; k < i; ++k) {
+            rhs[i] -= factor[i * n + k] * rhs[k];
+        }
+        rhs[i] /= factor[i * n + i];
+    }
+    for (int i = n - 1; i >= 0; --i) {
+        for (int k = i + 1; k < n; ++k) {
+            rhs[i] -= factor[k * n + i] * rhs[k];
+        }
+        rhs[i] /= factor[i * n + i];
+    }
+    return rhs;
+}
@@ -0,0 +1,234 @@
+#ifndef LONGSTAFF_SCHWARTZ_H
+#define LONGSTAFF_SCHWARTZ_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "monteCarlo.h"
+#include "observedPaths.h"
+#include "parallel.h"
+#include "runningStats.h"
+
+// Nombre de monômes x^a y^b de degré total a + b <= degree.
+inline int lsm_basis_size(int degree) { return (degree + 1) * (degree + 2) / 2; }
+
+// Degré maximal de la base: au-delà, la matrice normale devient mal conditionnée.
+constexpr int LSM_MAX_DEGREE = 6;
+
+// Base polynomiale en (x, y) = (S / S0, v / theta), ordonnée par degré total croissant:
+// 1, x, y, x^2, x y, y^2, ... Les variables réduites sont d'ordre 1, ce qui garde la matrice
+// normale raisonnablement conditionnée.
+inline void lsm_basis(int degree, double x, double y, double* phi) {
+    double x_power[LSM_MAX_DEGREE + 1], y_power[LSM_MAX_DEGREE + 1];
+    x_power[0] = y_power[0] = 1;
+    for (int d = 1; d <= degree; ++d) {
+        x_power[d] = x_power[d - 1] * x;
+        y_power[d] = y_power[d - 1] * y;
+    }
+    int k = 0;
+    for (int d = 0; d <= degree; ++d) {
+        for (int b = 0; b <= d; ++b) {
+            phi[k++] = x_power[d - b] * y_power[b];
+        }
+    }
+}
+
+// Résout les équations normales G beta = r (G symétrique n x n, seul le triangle inférieur
+// est lu) par Cholesky, avec une régularisation de Tikhonov relative à la diagonale si G est
+// numériquement singulière (dates où presque aucune trajectoire n'est dans la monnaie).
+std::vector<double> solve_normal_equations(std::vector<double> gram, std::vector<double> rhs,
+                                           int n);
+
+// Règle d'exercice estimée: à la date d'exercice k, exercer si la valeur intrinsèque est
+// positive et au moins égale à la continuation sum_j beta_kj phi_j(S, v). Aucune régression
+// à la dernière date (coefficients vides): l'option y est exercée si elle est dans la monnaie.
+struct LsmPolicy {
+    int degree = 2;
+    double S0 = 1, theta = 1;
+    std::vector<std::vector<double>> coefficients;  // une entrée par date d'exercice
+
+    double continuation(int k, double S, double v) const {
+        double phi[(LSM_MAX_DEGREE + 1) * (LSM_MAX_DEGREE + 2) / 2];
+        lsm_basis(degree, S / S0, v / theta, phi);
+        const std::vector<double>& beta = coefficients[k];
+        double c = 0;
+        for (size_t j = 0; j < beta.size(); ++j) {
+            c += beta[j] * phi[j];
+        }
+        return c;
+    }
+};
+
+struct LsmConfig {
+    int degree = 2;                 // degré total de la base en (S, v)
+    bool in_the_money_only = true;  // régression sur les seules trajectoires dans la monnaie
+    int threads = 0;
+    long block_size = 2048;         // trajectoires par bloc de la régression
+    Scheme scheme = Scheme::Euler;
+};
+
+struct LsmResult {
+    MonteCarloResult price;    // actualisé en 0, biaisé vers le haut (dans l'échantillon)
+    LsmPolicy policy;
+    double exercise_fraction;  // part des trajectoires exercées avant la dernière date
+};
+
+// Options bermudéennes / américaines par Longstaff-Schwartz sous Heston. Les M trajectoires
+// sont simulées sur la grille fine de N pas mais conservées aux seules dates d'exercice
+// (simulate_observed), puis remontées date par date: les flux de trésorerie courants sont
+// régressés sur la base en (S, v). Les équations normales sont accumulées en une passe par
+// blocs de trajectoires (sommes partielles G_b, r_b gardées dans un cache réutilisé d'une
+// date à l'autre), réduites dans l'ordre des blocs et résolues une fois par date: prix
+// indépendant du nombre de threads. payoff(S) est la valeur d'exercice.
+template <typename Payoff>
+LsmResult heston_lsm(const HestonParams& p, int N, long M,
+                     const std::vector<double>& exercise_times, const Payoff& payoff,
+                     std::uint64_t seed, const LsmConfig& config = LsmConfig()) {
+    if (config.degree < 0 || config.degree > LSM_MAX_DEGREE) {
+        throw std::invalid_argument("LSM basis degree must lie in [0, LSM_MAX_DEGREE]");
+    }
+    const std::vector<int> steps = observation_steps(p, N, exercise_times);
+    const ObservedPaths observed =
+        simulate_observed(p, N, M, steps, seed, config.threads, config.block_size, config.scheme);
+    const int K = static_cast<int>(steps.size());
+    const int nb = lsm_basis_size(config.degree);
+    const long block_size = config.block_size;
+    const long blocks = (M + block_size - 1) / block_size;
+
+    LsmResult result;
+    result.policy.degree = config.degree;
+    result.policy.S0 = p.S0;
+    result.policy.theta = p.theta;
+    result.policy.coefficients.assign(K, {});
+
+    // Flux actualisés à la date courante, et date d'exercice retenue par trajectoire.
+    std::vector<double> cash(M);
+    std::vector<int> exercised(M, K - 1);
+    const double* S_last = observed.paths.stock(K);
+    for (long m = 0; m < M; ++m) {
+        cash[m] = payoff(S_last[m]);
+    }
+    std::vector<double> normal(blocks * (nb * nb + nb));
+    for (int k = K - 2; k >= 0; --k) {
+        const double discount = std::exp(-p.drift * (observed.times[k + 1] - observed.times[k]));
+        const double* S = observed.paths.stock(k + 1);
+        const double* v = observed.paths.variance(k + 1);
+        std::fill(normal.begin(), normal.end(), 0.0);
+        parallel_for(0, blocks, config.threads, [&](long lo, long hi) {
+            double phi[(LSM_MAX_DEGREE + 1) * (LSM_MAX_DEGREE + 2) / 2];
+            for (long b = lo; b < hi; ++b) {
+                double* gram = normal.data() + b * (nb * nb + nb);
+                double* rhs = gram + nb * nb;
+                const long end = std::min(M, (b + 1) * block_size);
+                for (long m = b * block_size; m < end; ++m) {
+                    cash[m] *= discount;
+                    if (config.in_the_money_only && !(payoff(S[m]) > 0)) {
+                        continue;
+                    }
+                    lsm_basis(config.degree, S[m] / p.S0, v[m] / p.theta, phi);
+                    for (int i = 0; i < nb; ++i) {
+                        for (int j = 0; j <= i; ++j) {
+                            gram[i * nb + j] += phi[i] * phi[j];
+                        }
+                        rhs[i] += phi[i] * cash[m];
+                    }
+                }
+            }
+        });
+        std::vector<double> gram(nb * nb, 0.0), rhs(nb, 0.0);
+        for (long b = 0; b < blocks; ++b) {
+            const double* partial = normal.data() + b * (nb * nb + nb);
+            for (int i = 0; i < nb * nb + nb; ++i) {
+                (i < nb * nb ? gram[i] : rhs[i - nb * nb]) += partial[i];
+            }
+        }
+        if (gram[0] == 0) {
+            continue;  // aucune trajectoire dans la monnaie: jamais d'exercice à cette date
+        }
+        result.policy.coefficients[k] = solve_normal_equations(gram, rhs, nb);
+        parallel_for(0, M, config.threads, [&](long lo, long hi) {
+            for (long m = lo; m < hi; ++m) {
+                const double intrinsic = payoff(S[m]);
+                if (intrinsic > 0 && intrinsic >= result.policy.continuation(k, S[m], v[m])) {
+                    cash[m] = intrinsic;
+                    exercised[m] = k;
+                }
+            }
+        });
+    }
+
+    const double discount = std::exp(-p.drift * observed.times[0]);
+    std::vector<RunningStats> block_stats(blocks);
+    long early = 0;
+    for (long b = 0; b < blocks; ++b) {
+        const long end = std::min(M, (b + 1) * block_size);
+        for (long m = b * block_size; m < end; ++m) {
+            block_stats[b].add(discount * cash[m]);
+            early += exercised[m] < K - 1;
+        }
+    }
+    RunningStats total;
+    for (const RunningStats& s : block_stats) {
+        total.merge(s);
+    }
+    result.price = make_result(total);
+    result.exercise_fraction = static_cast<double>(early) / M;
+    return result;
+}
+
+// Politique de payoff (payoffs.h) appliquant une règle d'exercice LSM pendant la
+// propagation: avec des trajectoires indépendantes de celles de la régression, la moyenne
+// de value est un estimateur biaisé vers le bas du prix, sans aucun stockage. value(m) est
+// actualisée en 0. La règle est copiée: la politique reste valide après la destruction du
+// LsmResult dont elle vient (les copies par thread la partagent en lecture seule).
+template <typename Payoff>
+class LsmExercise {
+public:
+    LsmExercise(LsmPolicy policy, std::vector<int> steps, const Payoff& payoff)
+        : policy_(std::make_shared<const LsmPolicy>(std::move(policy))),
+          steps_(std::move(steps)),
+          payoff_(payoff) {}
+
+    void start(const HestonParams& p, int N, long n) {
+        dt_ = p.T / N;
+        drift_ = p.drift;
+        next_ = 0;
+        value_.assign(n, 0.0);
+        alive_.assign(n, 1);
+    }
+    void observe(int i, long n, const double* S, const double* v) {
+        if (next_ == steps_.size() || steps_[next_] != i) {
+            return;
+        }
+        const int k = static_cast<int>(next_++);
+        const bool last = next_ == steps_.size();
+        const double discount = std::exp(-drift_ * i * dt_);
+        for (long m = 0; m < n; ++m) {
+            if (!alive_[m]) {
+                continue;
+            }
+            const double intrinsic = payoff_(S[m]);
+            if (intrinsic > 0 && (last || (!policy_->coefficients[k].empty() &&
+                                           intrinsic >= policy_->continuation(k, S[m], v[m])))) {
+                value_[m] = discount * intrinsic;
+                alive_[m] = 0;
+            }
+        }
+    }
+    double value(long m) const { return value_[m]; }
+
+private:
+    std::shared_ptr<const LsmPolicy> policy_;
+    std::vector<int> steps_;
+    Payoff payoff_;
+    double dt_ = 0, drift_ = 0;
+    std::size_t next_ = 0;
+    std::vector<double> value_;
+    std::vector<char> alive_;
+};
+
+#endif // LONGSTAFF_SCHWARTZ_H
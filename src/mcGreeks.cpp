@@ -0,0 +1,79 @@
+#include "mcGreeks.h"
+#include <cmath>
+#include "normalBatch.h"
+
+using namespace std;
+
+void euler_tangent_block(const HestonParams& p, int N, uint64_t seed, long first_path, long n,
+                         TangentBlock& out) {
+    const double dt = p.T / N;
+    const double sqrt_dt = sqrt(dt);
+    const double rho_bar = sqrt(1 - p.rho * p.rho);
+    const double dw2_drho_z2 = -p.rho / rho_bar;  // d(rho z1 + rho_bar z2) / d rho, facteur de z2
+    const int P = TangentBlock::PARAMETERS;
+    thread_local NormalBatch normals;
+
+    out.S.assign(n, p.S0);
+    out.delta_weight.resize(n);
+    out.gamma_weight.resize(n);
+    out.vega_weight.resize(n);
+    vector<double> v(n, p.v0);
+    array<vector<double>, TangentBlock::PARAMETERS> dv;
+    for (int k = 0; k < P; ++k) {
+        out.dlog_S[k].assign(n, 0.0);
+        dv[k].assign(n, k == TangentBlock::V0 ? 1.0 : 0.0);
+    }
+
+    for (int i = 1; i <= N; ++i) {
+        normals.fill_independent(seed, first_path, n, i);
+        const double* z1 = normals.w1();
+        const double* z2 = normals.w2();
+        if (i == 1) {
+            // Premier pas: v_1 (avant troncature) et ln S_1 gaussiens sachant (S0, v0).
+            const double a = sqrt(p.v0 * dt);
+            const double s_v = p.sigma * a, s_x = rho_bar * a;
+            for (long m = 0; m < n; ++m) {
+                double dz1 = -(1 - p.kappa * dt) / s_v - z1[m] / (2 * p.v0);
+                double dmean_x = -0.5 * dt + p.rho * (a / (2 * p.v0) * z1[m] + a * dz1);
+                double dz2 = -dmean_x / s_x - z2[m] / (2 * p.v0);
+                out.vega_weight[m] = -1 / p.v0 - z1[m] * dz1 - z2[m] * dz2;
+                out.delta_weight[m] = z2[m] / (s_x * p.S0);
+                out.gamma_weight[m] =
+                    (z2[m] * z2[m] - 1 - s_x * z2[m]) / (s_x * s_x * p.S0 * p.S0);
+            }
+        }
+        for (long m = 0; m < n; ++m) {
+            // Mêmes opérations que NormalBatch::fill puis euler_step.
+            const double w1 = sqrt_dt * z1[m];
+            const double w2 = sqrt_dt * (p.rho * z1[m] + rho_bar * z2[m]);
+            const double vt_prev = max(0.0, v[m]);
+            const double sqrt_v = sqrt(vt_prev);
+            const double vt = vt_prev + p.kappa * (p.theta - vt_prev) * dt + p.sigma * sqrt_v * w1;
+            const bool positive = v[m] > 0;
+            for (int k = 0; k < P; ++k) {
+                double dv_prev = positive ? dv[k][m] : 0.0;
+                double dsqrt_v = sqrt_v > 0 ? dv_prev / (2 * sqrt_v) : 0.0;
+                double dvt = dv_prev * (1 - p.kappa * dt) + p.sigma * dsqrt_v * w1;
+                double dx = -0.5 * dv_prev * dt + dsqrt_v * w2;
+                switch (k) {
+                    case TangentBlock::KAPPA:
+                        dvt += (p.theta - vt_prev) * dt;
+                        break;
+                    case TangentBlock::THETA:
+                        dvt += p.kappa * dt;
+                        break;
+                    case TangentBlock::SIGMA:
+                        dvt += sqrt_v * w1;
+                        break;
+                    case TangentBlock::RHO:
+                        dx += sqrt_v * sqrt_dt * (z1[m] + dw2_drho_z2 * z2[m]);
+                        break;
+                }
+                dv[k][m] = vt > 0 ? dvt : 0.0;
+                out.dlog_S[k][m] += dx;
+            }
+            v[m] = max(0.0, vt);
+            out.S[m] *= exp((p.drift - 0.5 * vt_prev) * dt + sqrt_v * w2);
+        }
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef MC_GREEKS_H
+#define MC_GREEKS_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "monteCarlo.h"
+#include "parallel.h"
+#include "runningStats.h"
+
+// Sensibilités Monte Carlo (espérances non actualisées, comme les autres moteurs) issues
+// d'une seule simulation. Les dérivées trajectorielles (pathwise) supposent un payoff
+// lipschitzien; pour un payoff discontinu (digitale, barrière) on lit les estimateurs par
+// rapport de vraisemblance (_lr). vega est la dérivée par rapport à v0, comme HestonGreeks.
+struct MonteCarloGreeks {
+    MonteCarloResult price;
+    MonteCarloResult delta;  // pathwise
+    MonteCarloResult gamma;  // mixte: pathwise puis rapport de vraisemblance
+    MonteCarloResult vega;   // pathwise
+    MonteCarloResult dkappa;
+    MonteCarloResult dtheta;
+    MonteCarloResult dsigma;
+    MonteCarloResult drho;
+    MonteCarloResult delta_lr;
+    MonteCarloResult gamma_lr;
+    MonteCarloResult vega_lr;
+};
+
+// Valeurs terminales, dérivées tangentes et poids de vraisemblance d'un bloc de trajectoires.
+struct TangentBlock {
+    enum Parameter { V0, KAPPA, THETA, SIGMA, RHO, PARAMETERS };
+
+    std::vector<double> S;                                  // S_T
+    std::array<std::vector<double>, PARAMETERS> dlog_S;     // d ln S_T / d parametre
+    std::vector<double> delta_weight;                       // d ln p / d S0
+    std::vector<double> gamma_weight;                       // (d^2 p / d S0^2) / p
+    std::vector<double> vega_weight;                        // d ln p / d v0
+};
+
+// Euler tronqué (mêmes tirages Philox que simulate_block: S_T identique au bit près) avec
+// propagation des dérivées tangentes de (ln S, v) par rapport à v0, kappa, theta, sigma, rho;
+// d ln S_T / d S0 = 1 / S0. Les poids de vraisemblance portent sur la densité gaussienne du
+// premier pas, par laquelle seule S0 et v0 entrent dans la trajectoire (v0 > 0 requis).
+void euler_tangent_block(const HestonParams& p, int N, std::uint64_t seed, long first_path,
+                         long n, TangentBlock& out);
+
+// Grecques d'un payoff terminal payoff(S_T), de dérivée derivative(S_T) (prendre 0 pour un
+// payoff discontinu et utiliser les champs _lr). Résultat indépendant du nombre de threads.
+template <typename Payoff, typename Derivative>
+MonteCarloGreeks heston_mc_greeks(const HestonParams& p, int N, long M, const Payoff& payoff,
+                                  const Derivative& derivative, std::uint64_t seed,
+                                  int threads = 0, long block_size = 2048) {
+    enum { PRICE, DELTA, GAMMA, VEGA, KAPPA, THETA, SIGMA, RHO, DELTA_LR, GAMMA_LR, VEGA_LR,
+           COUNT };
+    using Stats = std::array<RunningStats, COUNT>;
+    const long blocks = (M + block_size - 1) / block_size;
+    std::vector<Stats> block_stats(blocks);
+
+    parallel_for(0, blocks, threads, [&](long lo, long hi) {
+        TangentBlock t;
+        for (long b = lo; b < hi; ++b) {
+            const long first = b * block_size;
+            const long n = std::min(block_size, M - first);
+            euler_tangent_block(p, N, seed, first, n, t);
+            Stats& s = block_stats[b];
+            for (long m = 0; m < n; ++m) {
+                const double ST = t.S[m];
+                const double f = payoff(ST);
+                const double df = derivative(ST);
+                s[PRICE].add(f);
+                s[DELTA].add(df * ST / p.S0);
+                // d/dS0 de f'(S_T) S_T / S0: score du premier pas moins la dépendance
+                // explicite en 1 / S0.
+                s[GAMMA].add(df * ST / p.S0 * (t.delta_weight[m] - 1 / p.S0));
+                s[VEGA].add(df * ST * t.dlog_S[TangentBlock::V0][m]);
+                s[KAPPA].add(df * ST * t.dlog_S[TangentBlock::KAPPA][m]);
+                s[THETA].add(df * ST * t.dlog_S[TangentBlock::THETA][m]);
+                s[SIGMA].add(df * ST * t.dlog_S[TangentBlock::SIGMA][m]);
+                s[RHO].add(df * ST * t.dlog_S[TangentBlock::RHO][m]);
+                s[DELTA_LR].add(f * t.delta_weight[m]);
+                s[GAMMA_LR].add(f * t.gamma_weight[m]);
+                s[VEGA_LR].add(f * t.vega_weight[m]);
+            }
+        }
+    });
+
+    Stats total;
+    for (const Stats& s : block_stats) {
+        for (int k = 0; k < COUNT; ++k) {
+            total[k].merge(s[k]);
+        }
+    }
+    MonteCarloGreeks g;
+    g.price = make_result(total[PRICE]);
+    g.delta = make_result(total[DELTA]);
+    g.gamma = make_result(total[GAMMA]);
+    g.vega = make_result(total[VEGA]);
+    g.dkappa = make_result(total[KAPPA]);
+    g.dtheta = make_result(total[THETA]);
+    g.dsigma = make_result(total[SIGMA]);
+    g.drho = make_result(total[RHO]);
+    g.delta_lr = make_result(total[DELTA_LR]);
+    g.gamma_lr = make_result(total[GAMMA_LR]);
+    g.vega_lr = make_result(total[VEGA_LR]);
+    return g;
+}
+
+#endif // MC_GREEKS_H
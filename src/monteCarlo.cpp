@@ -0,0 +1,93 @@
+#include "monteCarlo.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "exactSampling.h"
+
+using namespace std;
+
+void euler_step(const HestonParams& p, double dt, long n, double* S, double* v, const double* dW1,
+                const double* dW2) {
+    for (long m = 0; m < n; ++m) {
+        double vt_prev = max(0.0, v[m]);
+        double sqrt_v = sqrt(vt_prev);
+        double vt = vt_prev + p.kappa * (p.theta - vt_prev) * dt + p.sigma * sqrt_v * dW1[m];
+        v[m] = max(0.0, vt);
+        S[m] *= exp((p.drift - 0.5 * vt_prev) * dt + sqrt_v * dW2[m]);
+    }
+}
+
+void qe_step(const HestonParams& p, double dt, long n, double* S, double* v, const double* Zv,
+             const double* Zs) {
+    const double psi_c = 1.5;
+    const double gamma1 = 0.5, gamma2 = 0.5;
+    const double e = exp(-p.kappa * dt);
+    const double s2_v = p.sigma * p.sigma * e * (1 - e) / p.kappa;
+    const double s2_theta = p.theta * p.sigma * p.sigma * (1 - e) * (1 - e) / (2 * p.kappa);
+    const double k0 = -p.rho * p.kappa * p.theta * dt / p.sigma;
+    const double c = p.kappa * p.rho / p.sigma - 0.5;
+    const double k1 = gamma1 * dt * c - p.rho / p.sigma;
+    const double k2 = gamma2 * dt * c + p.rho / p.sigma;
+    const double k3 = gamma1 * dt * (1 - p.rho * p.rho);
+    const double k4 = gamma2 * dt * (1 - p.rho * p.rho);
+    const double A = k2 + 0.5 * k4;
+    for (long m = 0; m < n; ++m) {
+        const double vt_prev = v[m];
+        const double mean = p.theta + (vt_prev - p.theta) * e;
+        const double psi = (vt_prev * s2_v + s2_theta) / (mean * mean);
+        double vt, log_M;
+        bool martingale;
+        if (psi <= psi_c) {
+            double inv = 2 / psi;
+            double b2 = inv - 1 + sqrt(inv) * sqrt(inv - 1);
+            double a = mean / (1 + b2);
+            double x = sqrt(b2) + Zv[m];
+            vt = a * x * x;
+            martingale = A < 1 / (2 * a);
+            log_M = martingale ? A * b2 * a / (1 - 2 * A * a) - 0.5 * log(1 - 2 * A * a) : 0.0;
+        } else {
+            double prob = (psi - 1) / (psi + 1);
+            double beta = (1 - prob) / mean;
+            double u = 0.5 * erfc(-Zv[m] / sqrt(2.0));
+            vt = u <= prob ? 0.0 : log((1 - prob) / (1 - u)) / beta;
+            martingale = A < beta;
+            log_M = martingale ? log(prob + beta * (1 - prob) / (beta - A)) : 0.0;
+        }
+        // K0* = -ln M - (K1 + K3/2) v rend exp(ln S) martingale sous le schéma discret.
+        const double drift_term = martingale ? -log_M - (k1 + 0.5 * k3) * vt_prev : k0;
+        S[m] *= exp(p.drift * dt + drift_term + k1 * vt_prev + k2 * vt +
+                    sqrt(k3 * vt_prev + k4 * vt) * Zs[m]);
+        v[m] = vt;
+    }
+}
+
+void simulate_block(const HestonParams& p, int N, uint64_t seed, long first_path, long n,
+                    double* S, double* v, Scheme scheme) {
+    if (scheme == Scheme::Exact) {
+        exact_terminal(p, seed, first_path, n, S, v);
+        return;
+    }
+    step_block(p, N, seed, first_path, n, false, S, v, scheme,
+               [](int, const double*, const double*) {});
+}
+
+void simulate_paths_block(const HestonParams& p, int N, uint64_t seed, long first_path, long n,
+                          double* S, double* v, long stride, Scheme scheme) {
+    // Pas calculés dans un tampon de travail, recopié à la date i après chaque pas.
+    fill(S, S + n, p.S0);
+    fill(v, v + n, p.v0);
+    thread_local vector<double> S_work, v_work;
+    S_work.resize(n);
+    v_work.resize(n);
+    step_block(p, N, seed, first_path, n, false, S_work.data(), v_work.data(), scheme,
+               [&](int i, const double* S_i, const double* v_i) {
+                   copy(S_i, S_i + n, S + static_cast<long>(i) * stride);
+                   copy(v_i, v_i + n, v + static_cast<long>(i) * stride);
+               });
+}
+
+void simulate_antithetic_block(const HestonParams& p, int N, uint64_t seed, long first_pair,
+                               long pairs, double* S, double* v, Scheme scheme) {
+    step_block(p, N, seed, first_pair, 2 * pairs, true, S, v, scheme,
+               [](int, const double*, const double*) {});
+}
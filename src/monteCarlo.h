@@ -0,0 +1,283 @@
+#ifndef MONTE_CARLO_H
+#define MONTE_CARLO_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "normalBatch.h"
+#include "parallel.h"
+#include "runningStats.h"
+
+struct HestonParams {
+    double S0;
+    double drift;
+    double T;
+    double v0;
+    double kappa;
+    double theta;
+    double sigma;
+    double rho;
+};
+
+// Schéma de discrétisation de la variance: Euler tronqué ou Quadratic-Exponential
+// d'Andersen (2008) avec correction de martingale, peu biaisé même à grands pas.
+// Exact tire directement (S_T, v_T) sans pas de temps (voir exactSampling.h): N est alors
+// ignoré, ce qui ne convient qu'aux payoffs terminaux.
+enum class Scheme { Euler, QE, Exact };
+
+// Un pas d'Euler tronqué (même schéma que HestonSimulation) pour n trajectoires contiguës;
+// dW1 pilote la variance, dW2 (déjà corrélé) le sous-jacent.
+void euler_step(const HestonParams& p, double dt, long n, double* S, double* v, const double* dW1,
+                const double* dW2);
+
+// Un pas QE pour n trajectoires; Zv et Zs sont des normales standard indépendantes
+// (la corrélation passe par les coefficients K0..K4 d'Andersen). Dans la zone
+// exponentielle, l'uniforme est Phi(Zv).
+void qe_step(const HestonParams& p, double dt, long n, double* S, double* v, const double* Zv,
+             const double* Zs);
+
+// Moteur commun des simulate_*_block: propage n trajectoires de S0, v0 jusqu'à maturité avec
+// les normales Philox indexées par (graine, trajectoire, pas) et appelle observe(i, S, v)
+// après chaque pas i = 1..N. En antithétique, n = 2 * paires: les trajectoires k et
+// n / 2 + k utilisent les normales de first_path + k, la seconde avec le signe opposé.
+template <typename Observer>
+void step_block(const HestonParams& p, int N, std::uint64_t seed, long first_path, long n,
+                bool antithetic, double* S, double* v, Scheme scheme, Observer&& observe) {
+    if (scheme == Scheme::Exact) {
+        throw std::invalid_argument("path simulation requires the Euler or QE scheme");
+    }
+    const double dt = p.T / N;
+    const double sqrt_dt = std::sqrt(dt);
+    const long drawn = antithetic ? n / 2 : n;
+    thread_local NormalBatch normals;
+    thread_local std::vector<double> w1, w2;
+    std::fill(S, S + n, p.S0);
+    std::fill(v, v + n, p.v0);
+    for (int i = 1; i <= N; ++i) {
+        if (scheme == Scheme::QE) {
+            normals.fill_independent(seed, first_path, drawn, i);
+        } else {
+            normals.fill(seed, first_path, drawn, i, p.rho, sqrt_dt);
+        }
+        const double* dW1 = normals.w1();
+        const double* dW2 = normals.w2();
+        if (antithetic) {
+            // Pour QE, Phi(-Zv) = 1 - Phi(Zv): l'uniforme de la zone exponentielle est aussi
+            // opposée.
+            w1.resize(n);
+            w2.resize(n);
+            for (long k = 0; k < drawn; ++k) {
+                w1[k] = dW1[k];
+                w2[k] = dW2[k];
+                w1[drawn + k] = -dW1[k];
+                w2[drawn + k] = -dW2[k];
+            }
+            dW1 = w1.data();
+            dW2 = w2.data();
+        }
+        if (scheme == Scheme::QE) {
+            qe_step(p, dt, n, S, v, dW1, dW2);
+        } else {
+            euler_step(p, dt, n, S, v, dW1, dW2);
+        }
+        observe(i, S, v);
+    }
+}
+
+// Propage les trajectoires [first_path, first_path + n) jusqu'à maturité avec des normales
+// Philox indexées par (graine, trajectoire, pas): le résultat ne dépend pas de l'ordre
+// de traitement des blocs. Les normales sont générées par lots (NormalBatch, un par thread).
+void simulate_block(const HestonParams& p, int N, std::uint64_t seed, long first_path, long n,
+                    double* S, double* v, Scheme scheme = Scheme::Euler);
+
+// Comme simulate_block, mais conserve toutes les dates: la date i des n trajectoires est
+// écrite en S + i * stride et v + i * stride (stride >= n), comme dans un PathSet. Mêmes
+// tirages que simulate_block: la dernière date lui est identique au bit près. Euler et QE.
+void simulate_paths_block(const HestonParams& p, int N, std::uint64_t seed, long first_path,
+                          long n, double* S, double* v, long stride,
+                          Scheme scheme = Scheme::Euler);
+
+// Variante antithétique: S[k], v[k] (k < pairs) suivent exactement les trajectoires
+// first_pair + k de simulate_block, S[pairs + k], v[pairs + k] les mêmes normales opposées.
+// S et v ont 2 * pairs éléments. Schémas Euler et QE seulement.
+void simulate_antithetic_block(const HestonParams& p, int N, std::uint64_t seed, long first_pair,
+                               long pairs, double* S, double* v, Scheme scheme = Scheme::Euler);
+
+// Monte Carlo en flux: les trajectoires sont propagées par blocs de block_size (tenant en
+// cache) et seul payoff(S_T) est accumulé. Mémoire O(block_size), indépendante de M et N.
+template <typename Payoff>
+MonteCarloResult heston_mc_stream(const HestonParams& p, int N, long M, Payoff&& payoff,
+                                  long block_size = 2048) {
+    const double dt = p.T / N;
+    const double sqrt_dt = std::sqrt(dt);
+    const double rho_bar = std::sqrt(1 - p.rho * p.rho);
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::normal_distribution<> dW(0, sqrt_dt);
+
+    std::vector<double> S(block_size), v(block_size), dW1(block_size), dW2(block_size);
+    RunningStats stats;
+    for (long start = 0; start < M; start += block_size) {
+        const long n = std::min(block_size, M - start);
+        std::fill(S.begin(), S.begin() + n, p.S0);
+        std::fill(v.begin(), v.begin() + n, p.v0);
+        for (int i = 1; i <= N; ++i) {
+            for (long m = 0; m < n; ++m) {
+                dW1[m] = dW(gen);
+                dW2[m] = p.rho * dW1[m] + rho_bar * dW(gen);
+            }
+            euler_step(p, dt, n, S.data(), v.data(), dW1.data(), dW2.data());
+        }
+        for (long m = 0; m < n; ++m) {
+            stats.add(payoff(S[m]));
+        }
+    }
+    return make_result(stats);
+}
+
+// Monte Carlo multithread reproductible: les blocs de trajectoires ont un découpage fixe,
+// chaque bloc a ses propres statistiques et la réduction se fait dans l'ordre des blocs.
+// Le résultat est identique au bit près quel que soit le nombre de threads.
+// payoff(S_T) doit pouvoir être appelé simultanément depuis plusieurs threads.
+template <typename Payoff>
+MonteCarloResult heston_mc_parallel(const HestonParams& p, int N, long M, const Payoff& payoff,
+                                    std::uint64_t seed, int threads = 0, long block_size = 2048,
+                                    Scheme scheme = Scheme::Euler) {
+    const long blocks = (M + block_size - 1) / block_size;
+    std::vector<RunningStats> block_stats(blocks);
+    std::atomic<long> next(0);
+
+    auto worker = [&]() {
+        std::vector<double> S(block_size), v(block_size);
+        for (long b = next++; b < blocks; b = next++) {
+            const long first = b * block_size;
+            const long n = std::min(block_size, M - first);
+            simulate_block(p, N, seed, first, n, S.data(), v.data(), scheme);
+            for (long m = 0; m < n; ++m) {
+                block_stats[b].add(payoff(S[m]));
+            }
+        }
+    };
+
+    if (threads <= 0) {
+        threads = default_thread_count();
+    }
+    threads = static_cast<int>(std::min<long>(threads, std::max(1L, blocks)));
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& t : pool) {
+        t.join();
+    }
+
+    RunningStats total;
+    for (const RunningStats& s : block_stats) {
+        total.merge(s);
+    }
+    return make_result(total);
+}
+
+// Critère d'arrêt du Monte Carlo adaptatif: on s'arrête dès que la demi-largeur de
+// l'intervalle de confiance passe sous max(absolute_tolerance, relative_tolerance * |moyenne|),
+// ou quand plus aucun bloc ne tient avant l'échéance, ou à max_paths trajectoires.
+struct AdaptiveStopping {
+    double absolute_tolerance = 0.0;
+    double relative_tolerance = 1e-3;
+    double z = 1.96;
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    long min_paths = 16384;                      // premier lot, avant tout test
+    long max_paths = 1L << 30;
+};
+
+struct AdaptiveMonteCarloResult {
+    MonteCarloResult result;  // result.paths: trajectoires simulées
+    double seconds;           // temps écoulé
+    int batches;
+    bool converged;           // tolérance atteinte
+};
+
+// Monte Carlo par lots jusqu'à la précision demandée, sans fixer M à l'avance. Après chaque
+// lot, la variance courante donne le nombre de trajectoires encore nécessaires; le lot
+// suivant en simule autant (au plus le double du total, arrondi aux blocs). Les blocs sont
+// ceux de heston_mc_parallel: à arrêt identique, l'estimation lui est identique au bit près
+// et ne dépend pas du nombre de threads (seul l'arrêt sur échéance dépend de la machine).
+template <typename Payoff>
+AdaptiveMonteCarloResult heston_mc_adaptive(const HestonParams& p, int N, const Payoff& payoff,
+                                            std::uint64_t seed, const AdaptiveStopping& stop,
+                                            int threads = 0, long block_size = 2048,
+                                            Scheme scheme = Scheme::Euler) {
+    const auto start = std::chrono::steady_clock::now();
+    RunningStats total;
+    long next_block = 0;
+    long batch = std::max(1L, (stop.min_paths + block_size - 1) / block_size) * block_size;
+    int batches = 0;
+    bool converged = false;
+    for (;;) {
+        batch = std::min(batch, stop.max_paths - total.count());
+        const long blocks = (batch + block_size - 1) / block_size;
+        const long M = next_block * block_size + batch;
+        std::vector<RunningStats> block_stats(blocks);
+        const long batch_paths = batch;
+        const auto batch_start = std::chrono::steady_clock::now();
+        parallel_for(0, blocks, threads, [&](long lo, long hi) {
+            std::vector<double> S(block_size), v(block_size);
+            for (long b = lo; b < hi; ++b) {
+                const long first = (next_block + b) * block_size;
+                const long n = std::min(block_size, M - first);
+                simulate_block(p, N, seed, first, n, S.data(), v.data(), scheme);
+                for (long m = 0; m < n; ++m) {
+                    block_stats[b].add(payoff(S[m]));
+                }
+            }
+        });
+        for (const RunningStats& s : block_stats) {
+            total.merge(s);
+        }
+        next_block += blocks;
+        ++batches;
+        const auto now = std::chrono::steady_clock::now();
+        const double last_batch = std::chrono::duration<double>(now - batch_start).count();
+
+        const double target = std::max(stop.absolute_tolerance,
+                                       stop.relative_tolerance * std::fabs(total.mean()));
+        const double half_width = total.half_width(stop.z);
+        if (half_width <= target) {
+            converged = true;
+            break;
+        }
+        if (total.count() >= stop.max_paths) {
+            break;
+        }
+        // Trajectoires nécessaires: n (h / cible)^2, lot suivant borné par le total courant.
+        const double ratio = target > 0 ? half_width / target : 2.0;
+        const double needed = total.count() * (ratio * ratio - 1);
+        batch = static_cast<long>(std::min(needed, static_cast<double>(total.count())));
+        batch = std::max(block_size, (batch + block_size - 1) / block_size * block_size);
+        // Le lot suivant est réduit à ce que l'échéance permet au débit du lot précédent.
+        const double per_path = last_batch / batch_paths;
+        const double remaining = std::chrono::duration<double>(stop.deadline - now).count();
+        if (per_path > 0 && remaining < per_path * batch) {
+            batch = static_cast<long>(remaining / per_path) / block_size * block_size;
+            if (batch <= 0) {
+                break;
+            }
+        }
+    }
+    AdaptiveMonteCarloResult out;
+    out.result = make_result(total, stop.z);
+    out.seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    out.batches = batches;
+    out.converged = converged;
+    return out;
+}
+
+#endif // MONTE_CARLO_H
@@ -0,0 +1,55 @@
+#include "monteCarloF32.h"
+#include <cmath>
+#include "normalBatch.h"
+
+using namespace std;
+
+void euler_step_f32(const HestonParams& p, float dt, long n, float* __restrict log_S,
+                    float* __restrict v, const float* __restrict z1,
+                    const float* __restrict z2) {
+    const float sqrt_dt = sqrt(dt);
+    const float kappa = static_cast<float>(p.kappa), theta = static_cast<float>(p.theta);
+    const float sigma = static_cast<float>(p.sigma), drift = static_cast<float>(p.drift);
+    const float rho = static_cast<float>(p.rho);
+    const float rho_bar = static_cast<float>(sqrt(1 - p.rho * p.rho));
+    for (long m = 0; m < n; ++m) {
+        const float vt_prev = max(0.0f, v[m]);
+        const float sqrt_v = sqrt(vt_prev);
+        const float dW1 = sqrt_dt * z1[m];
+        const float dW2 = sqrt_dt * (rho * z1[m] + rho_bar * z2[m]);
+        v[m] = max(0.0f, vt_prev + kappa * (theta - vt_prev) * dt + sigma * sqrt_v * dW1);
+        log_S[m] += (drift - 0.5f * vt_prev) * dt + sqrt_v * dW2;
+    }
+}
+
+void simulate_block_f32(const HestonParams& p, int N, uint64_t seed, long first_path, long n,
+                        float* S, float* v) {
+    const float dt = static_cast<float>(p.T / N);
+    thread_local NormalBatch uniforms;
+    thread_local vector<float> z1, z2;
+    z1.resize(n);
+    z2.resize(n);
+    fill(S, S + n, static_cast<float>(log(p.S0)));
+    fill(v, v + n, static_cast<float>(p.v0));
+    for (int i = 1; i <= N; ++i) {
+        uniforms.fill_uniforms(seed, first_path, n, i);
+        const double* __restrict u1 = uniforms.w1();
+        const double* __restrict u2 = uniforms.w2();
+        float* __restrict a = z1.data();
+        float* __restrict b = z2.data();
+        // Box-Muller en float, en passes séparées comme NormalBatch.
+        for (long m = 0; m < n; ++m) {
+            a[m] = sqrt(-2.0f * log(static_cast<float>(u1[m])));
+        }
+        for (long m = 0; m < n; ++m) {
+            const float angle = 6.2831853f * static_cast<float>(u2[m]);
+            const float radius = a[m];
+            a[m] = radius * cos(angle);
+            b[m] = radius * sin(angle);
+        }
+        euler_step_f32(p, dt, n, S, v, a, b);
+    }
+    for (long m = 0; m < n; ++m) {
+        S[m] = exp(S[m]);
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef MONTE_CARLO_F32_H
+#define MONTE_CARLO_F32_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "monteCarlo.h"
+#include "parallel.h"
+#include "runningStats.h"
+
+// Accumulation des payoffs du moteur float32: RunningStats en double, ou sommes de
+// Kahan en float par bloc (pour un pipeline entièrement en simple précision), les blocs
+// étant ensuite réduits en double.
+enum class Accumulator { Double, Kahan };
+
+// Un pas d'Euler tronqué en float sur ln S (pas d'exponentielle par pas): z1, z2 sont des
+// normales standard indépendantes, la corrélation et le facteur sqrt(dt) sont appliqués ici.
+void euler_step_f32(const HestonParams& p, float dt, long n, float* log_S, float* v,
+                    const float* z1, const float* z2);
+
+// Même découpage et mêmes uniformes Philox que simulate_block (Euler), Box-Muller et pas en
+// float: chaque trajectoire suit celle du moteur double aux arrondis près. Sorties S_T, v_T.
+void simulate_block_f32(const HestonParams& p, int N, std::uint64_t seed, long first_path,
+                        long n, float* S, float* v);
+
+// Monte Carlo float32 (schéma d'Euler), payoff(S_T) évalué en double. Mêmes blocs et même
+// réduction que heston_mc_parallel: résultat indépendant du nombre de threads.
+template <typename Payoff>
+MonteCarloResult heston_mc_f32(const HestonParams& p, int N, long M, const Payoff& payoff,
+                               std::uint64_t seed, int threads = 0, long block_size = 2048,
+                               Accumulator accumulator = Accumulator::Double) {
+    const long blocks = (M + block_size - 1) / block_size;
+    std::vector<RunningStats> block_stats(blocks);
+    parallel_for(0, blocks, threads, [&](long lo, long hi) {
+        std::vector<float> S(block_size), v(block_size);
+        for (long b = lo; b < hi; ++b) {
+            const long first = b * block_size;
+            const long n = std::min(block_size, M - first);
+            simulate_block_f32(p, N, seed, first, n, S.data(), v.data());
+            if (accumulator == Accumulator::Kahan) {
+                // Écarts au premier payoff du bloc: la somme des carrés bruts perdrait la
+                // variance par cancellation en float.
+                const float shift = static_cast<float>(payoff(static_cast<double>(S[0])));
+                KahanSum<float> sum, sum_squares;
+                for (long m = 0; m < n; ++m) {
+                    const float x = static_cast<float>(payoff(static_cast<double>(S[m]))) - shift;
+                    sum.add(x);
+                    sum_squares.add(x * x);
+                }
+                block_stats[b] =
+                    RunningStats::from_sums(n, sum.sum(), sum_squares.sum(), shift);
+            } else {
+                for (long m = 0; m < n; ++m) {
+                    block_stats[b].add(payoff(static_cast<double>(S[m])));
+                }
+            }
+        }
+    });
+    RunningStats total;
+    for (const RunningStats& s : block_stats) {
+        total.merge(s);
+    }
+    return make_result(total);
+}
+
+#endif // MONTE_CARLO_F32_H
@@ -0,0 +1,128 @@
+#include "multiAsset.h"
+#include <cmath>
+#include <stdexcept>
+#include "normalBatch.h"
+#include "philox.h"
+
+using namespace std;
+
+namespace {
+
+// Trajectoires par tuile lors de l'application de L: 2d lignes de z et w restent en L1/L2.
+constexpr long kTile = 64;
+
+}  // namespace
+
+vector<double> heston_correlation(const vector<HestonParams>& assets,
+                                  const vector<double>& spot_correlation) {
+    const size_t d = assets.size();
+    if (spot_correlation.size() != d * d) {
+        throw invalid_argument("spot correlation must be a d x d matrix");
+    }
+    const size_t dim = 2 * d;
+    vector<double> c(dim * dim);
+    for (size_t i = 0; i < d; ++i) {
+        for (size_t j = 0; j < d; ++j) {
+            const double s = spot_correlation[i * d + j];
+            const double ri = assets[i].rho, rj = assets[j].rho;
+            c[(2 * i + 1) * dim + 2 * j + 1] = s;
+            c[(2 * i) * dim + 2 * j + 1] = ri * s;
+            c[(2 * i + 1) * dim + 2 * j] = rj * s;
+            c[(2 * i) * dim + 2 * j] = i == j ? 1.0 : ri * rj * s;
+        }
+    }
+    return c;
+}
+
+vector<double> cholesky_factor(const vector<double>& a, int dim) {
+    if (a.size() != static_cast<size_t>(dim) * dim) {
+        throw invalid_argument("correlation matrix has the wrong size");
+    }
+    vector<double> L(a.size(), 0.0);
+    for (int i = 0; i < dim; ++i) {
+        for (int j = 0; j <= i; ++j) {
+            if (fabs(a[i * dim + j] - a[j * dim + i]) > 1e-12) {
+                throw invalid_argument("correlation matrix must be symmetric");
+            }
+            double sum = a[i * dim + j];
+            for (int k = 0; k < j; ++k) {
+                sum -= L[i * dim + k] * L[j * dim + k];
+            }
+            if (i == j) {
+                if (sum <= 0) {
+                    throw invalid_argument("correlation matrix must be positive definite");
+                }
+                L[i * dim + i] = sqrt(sum);
+            } else {
+                L[i * dim + j] = sum / L[j * dim + j];
+            }
+        }
+    }
+    return L;
+}
+
+MultiAssetHeston::MultiAssetHeston(vector<HestonParams> assets, const vector<double>& correlation)
+    : assets_(move(assets)) {
+    if (assets_.empty()) {
+        throw invalid_argument("at least one asset is required");
+    }
+    for (const HestonParams& p : assets_) {
+        if (p.T != assets_.front().T) {
+            throw invalid_argument("all assets must share the same maturity");
+        }
+    }
+    cholesky_ = cholesky_factor(correlation, drivers());
+}
+
+void MultiAssetHeston::correlate(long n, const double* z, double* w, double scale) const {
+    const int dim = drivers();
+    for (long lo = 0; lo < n; lo += kTile) {
+        const long hi = min(n, lo + kTile);
+        for (int r = 0; r < dim; ++r) {
+            double* out = w + r * n;
+            const double* row = cholesky_.data() + r * dim;
+            const double diag = scale * row[r];
+            const double* zr = z + r * n;
+            for (long m = lo; m < hi; ++m) {
+                out[m] = diag * zr[m];
+            }
+            for (int c = 0; c < r; ++c) {
+                const double l = scale * row[c];
+                if (l == 0) {
+                    continue;
+                }
+                const double* zc = z + c * n;
+                for (long m = lo; m < hi; ++m) {
+                    out[m] += l * zc[m];
+                }
+            }
+        }
+    }
+}
+
+void simulate_multi_asset_block(const MultiAssetHeston& model, int N, uint64_t seed,
+                                long first_path, long n, double* S, double* v) {
+    const int d = model.assets();
+    const double dt = model.maturity() / N;
+    const double sqrt_dt = sqrt(dt);
+    thread_local NormalBatch normals;
+    thread_local vector<double> z, w;
+    z.resize(2 * d * n);
+    w.resize(2 * d * n);
+    for (int j = 0; j < d; ++j) {
+        fill(S + j * n, S + (j + 1) * n, model.asset(j).S0);
+        fill(v + j * n, v + (j + 1) * n, model.asset(j).v0);
+    }
+    for (int i = 1; i <= N; ++i) {
+        for (int j = 0; j < d; ++j) {
+            normals.fill_independent(seed, first_path, n, i, STREAM_MULTI_ASSET + j);
+            copy(normals.w1(), normals.w1() + n, z.data() + (2 * j) * n);
+            copy(normals.w2(), normals.w2() + n, z.data() + (2 * j + 1) * n);
+        }
+        model.correlate(n, z.data(), w.data(), sqrt_dt);
+        for (int j = 0; j < d; ++j) {
+            euler_step(model.asset(j), dt, n, S + j * n, v + j * n, w.data() + (2 * j) * n,
+                       w.data() + (2 * j + 1) * n);
+        }
+    }
+}
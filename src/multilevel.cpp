@@ -0,0 +1,109 @@
+#include "multilevel.h"
+#include <cmath>
+#include "normalBatch.h"
+#include "philox.h"
+
+using namespace std;
+
+namespace {
+
+// Taux de décroissance r tel que |y_l| ~ 2^{-r l}, ajusté par moindres carrés sur l >= 1 et
+// borné à [lo, hi]: un niveau fin bruité ne doit pas faire conclure à une convergence trop
+// rapide (Euler: biais d'ordre au plus h, variance entre h^1/2 et h).
+double decay_rate(const vector<double>& y, double lo, double hi) {
+    double sx = 0, sy = 0, sxx = 0, sxy = 0;
+    int count = 0;
+    for (size_t l = 1; l < y.size(); ++l) {
+        if (y[l] <= 0) {
+            continue;
+        }
+        double x = static_cast<double>(l), ly = log2(y[l]);
+        sx += x;
+        sy += ly;
+        sxx += x * x;
+        sxy += x * ly;
+        ++count;
+    }
+    if (count < 2) {
+        return lo;
+    }
+    double slope = (count * sxy - sx * sy) / (count * sxx - sx * sx);
+    return min(hi, max(lo, -slope));
+}
+
+}  // namespace
+
+void mlmc_block(const HestonParams& p, int level, int steps, uint64_t seed, uint64_t first,
+                long n, PathSet& fine, PathSet* coarse) {
+    const double dt = p.T / steps;
+    const double sqrt_dt = sqrt(dt);
+    thread_local NormalBatch normals;
+    thread_local vector<double> acc1, acc2;
+    acc1.assign(n, 0.0);
+    acc2.assign(n, 0.0);
+
+    fill(fine.stock(0), fine.stock(0) + n, p.S0);
+    fill(fine.variance(0), fine.variance(0) + n, p.v0);
+    if (coarse) {
+        fill(coarse->stock(0), coarse->stock(0) + n, p.S0);
+        fill(coarse->variance(0), coarse->variance(0) + n, p.v0);
+    }
+    for (int i = 1; i <= steps; ++i) {
+        normals.fill(seed, static_cast<long>(first), n, i, p.rho, sqrt_dt,
+                     STREAM_MLMC_LEVEL + level);
+        copy(fine.stock(i - 1), fine.stock(i - 1) + n, fine.stock(i));
+        copy(fine.variance(i - 1), fine.variance(i - 1) + n, fine.variance(i));
+        euler_step(p, dt, n, fine.stock(i), fine.variance(i), normals.w1(), normals.w2());
+        if (!coarse) {
+            continue;
+        }
+        for (long m = 0; m < n; ++m) {
+            acc1[m] += normals.w1()[m];
+            acc2[m] += normals.w2()[m];
+        }
+        if (i % 2 == 0) {
+            const int c = i / 2;
+            copy(coarse->stock(c - 1), coarse->stock(c - 1) + n, coarse->stock(c));
+            copy(coarse->variance(c - 1), coarse->variance(c - 1) + n, coarse->variance(c));
+            euler_step(p, 2 * dt, n, coarse->stock(c), coarse->variance(c), acc1.data(),
+                       acc2.data());
+            fill(acc1.begin(), acc1.end(), 0.0);
+            fill(acc2.begin(), acc2.end(), 0.0);
+        }
+    }
+}
+
+vector<long> mlmc_optimal_paths(const vector<MlmcLevel>& levels, double variance_budget) {
+    // Variances des niveaux peu échantillonnés bornées inférieurement par extrapolation.
+    vector<double> V(levels.size());
+    for (size_t l = 0; l < levels.size(); ++l) {
+        V[l] = levels[l].variance;
+    }
+    const double beta = decay_rate(V, 0.5, 2.0);
+    for (size_t l = 2; l < V.size(); ++l) {
+        V[l] = max(V[l], 0.5 * V[l - 1] / pow(2.0, beta));
+    }
+    double sum = 0;
+    for (size_t l = 0; l < levels.size(); ++l) {
+        sum += sqrt(V[l] * levels[l].cost);
+    }
+    vector<long> paths(levels.size());
+    for (size_t l = 0; l < levels.size(); ++l) {
+        paths[l] = static_cast<long>(ceil(sqrt(V[l] / levels[l].cost) * sum / variance_budget));
+    }
+    return paths;
+}
+
+double mlmc_remaining_bias(const vector<MlmcLevel>& levels) {
+    const int L = static_cast<int>(levels.size()) - 1;
+    vector<double> mean(levels.size());
+    for (int l = 0; l <= L; ++l) {
+        mean[l] = fabs(levels[l].mean);
+    }
+    const double alpha = decay_rate(mean, 0.5, 1.0);
+    double rem = 0;
+    for (int k = 0; k <= 2 && L - k >= 1; ++k) {
+        rem = max(rem, mean[L - k] * pow(2.0, -alpha * k));
+    }
+    return rem / (pow(2.0, alpha) - 1);
+}
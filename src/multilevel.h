@@ -0,0 +1,145 @@
+#ifndef MULTILEVEL_H
+#define MULTILEVEL_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "monteCarlo.h"
+#include "parallel.h"
+#include "pathSet.h"
+#include "runningStats.h"
+
+struct MlmcConfig {
+    int base_steps = 16;        // N_0; le niveau l a base_steps * 2^l pas
+    int min_levels = 3;         // niveaux simulés d'emblée
+    int max_levels = 10;
+    long initial_paths = 1000;  // trajectoires d'essai par nouveau niveau
+    int threads = 0;
+    long block_size = 256;
+};
+
+struct MlmcLevel {
+    int steps;
+    long paths;
+    double mean;           // E[P_l - P_{l-1}] (E[P_0] au niveau 0)
+    double variance;       // Var[P_l - P_{l-1}]
+    double fine_variance;  // Var[P_l], pour comparer au MC à un seul niveau
+    double cost;           // pas de schéma par trajectoire (fine + grossière)
+};
+
+struct MlmcResult {
+    double estimate;
+    double std_error;
+    double bias;  // estimation du biais résiduel au niveau le plus fin
+    double cost;  // pas de schéma au total
+    bool converged;
+    std::vector<MlmcLevel> levels;
+};
+
+// Trajectoires couplées du niveau l pour les indices [first, first + n): fine (steps pas)
+// et, si coarse n'est pas nul, grossière (steps / 2 pas) pilotée par la somme des
+// incréments browniens fins deux à deux. Euler tronqué, normales Philox du flux propre au
+// niveau: les niveaux sont indépendants entre eux.
+void mlmc_block(const HestonParams& p, int level, int steps, std::uint64_t seed,
+                std::uint64_t first, long n, PathSet& fine, PathSet* coarse);
+
+// Nombre de trajectoires optimal par niveau (Giles 2008): N_l proportionnel à
+// sqrt(V_l / C_l), la variance totale valant variance_budget.
+std::vector<long> mlmc_optimal_paths(const std::vector<MlmcLevel>& levels,
+                                     double variance_budget);
+
+// Biais résiduel estimé à partir des derniers niveaux, E[P_l - P_{l-1}] ~ 2^{-alpha l}.
+double mlmc_remaining_bias(const std::vector<MlmcLevel>& levels);
+
+// Monte Carlo multiniveau pour un payoff dépendant du chemin, payoff(PathView) évalué sur les
+// trajectoires fines et grossières. Les niveaux sont ajoutés et les trajectoires réparties
+// automatiquement pour atteindre une RMSE target_rmse (moitié variance, moitié biais^2) au
+// coût minimal. Résultat indépendant du nombre de threads.
+template <typename Payoff>
+MlmcResult heston_mlmc(const HestonParams& p, const Payoff& payoff, double target_rmse,
+                       std::uint64_t seed, const MlmcConfig& config = MlmcConfig()) {
+    std::vector<MlmcLevel> levels;
+    std::vector<RunningStats> diff_stats, fine_stats;
+    std::vector<long> extra;
+
+    auto add_level = [&]() {
+        const int l = static_cast<int>(levels.size());
+        const int steps = config.base_steps << l;
+        levels.push_back({steps, 0, 0.0, 0.0, 0.0, steps + (l > 0 ? steps / 2.0 : 0.0)});
+        diff_stats.emplace_back();
+        fine_stats.emplace_back();
+        extra.push_back(config.initial_paths);
+    };
+    auto run_level = [&](int l, long count) {
+        const int steps = levels[l].steps;
+        const long first_index = levels[l].paths;
+        const long blocks = (count + config.block_size - 1) / config.block_size;
+        std::vector<RunningStats> block_diff(blocks), block_fine(blocks);
+        parallel_for(0, blocks, config.threads, [&](long lo, long hi) {
+            PathSet fine(steps, config.block_size);
+            PathSet coarse(l > 0 ? steps / 2 : 0, l > 0 ? config.block_size : 0);
+            for (long b = lo; b < hi; ++b) {
+                const long offset = b * config.block_size;
+                const long n = std::min(config.block_size, count - offset);
+                mlmc_block(p, l, steps, seed, first_index + offset, n, fine,
+                           l > 0 ? &coarse : nullptr);
+                for (long m = 0; m < n; ++m) {
+                    double pf = payoff(fine.path(m));
+                    double pc = l > 0 ? payoff(coarse.path(m)) : 0.0;
+                    block_diff[b].add(pf - pc);
+                    block_fine[b].add(pf);
+                }
+            }
+        });
+        for (long b = 0; b < blocks; ++b) {
+            diff_stats[l].merge(block_diff[b]);
+            fine_stats[l].merge(block_fine[b]);
+        }
+        levels[l].paths += count;
+        levels[l].mean = diff_stats[l].mean();
+        levels[l].variance = diff_stats[l].variance();
+        levels[l].fine_variance = fine_stats[l].variance();
+    };
+
+    for (int l = 0; l < config.min_levels; ++l) {
+        add_level();
+    }
+    const double variance_budget = 0.5 * target_rmse * target_rmse;
+    bool converged = false;
+    for (;;) {
+        for (std::size_t l = 0; l < levels.size(); ++l) {
+            if (extra[l] > 0) {
+                run_level(static_cast<int>(l), extra[l]);
+            }
+        }
+        std::vector<long> wanted = mlmc_optimal_paths(levels, variance_budget);
+        bool settled = true;
+        for (std::size_t l = 0; l < levels.size(); ++l) {
+            extra[l] = std::max(0L, wanted[l] - levels[l].paths);
+            settled = settled && extra[l] <= levels[l].paths / 100;
+        }
+        if (!settled) {
+            continue;
+        }
+        if (mlmc_remaining_bias(levels) <= target_rmse / std::sqrt(2.0)) {
+            converged = true;
+            break;
+        }
+        if (static_cast<int>(levels.size()) >= config.max_levels) {
+            break;
+        }
+        add_level();
+    }
+
+    MlmcResult result{0.0, 0.0, mlmc_remaining_bias(levels), 0.0, converged, levels};
+    double variance = 0.0;
+    for (const MlmcLevel& level : levels) {
+        result.estimate += level.mean;
+        variance += level.variance / level.paths;
+        result.cost += level.cost * level.paths;
+    }
+    result.std_error = std::sqrt(variance);
+    return result;
+}
+
+#endif // MULTILEVEL_H
@@ -0,0 +1,94 @@
+#include "normalBatch.h"
+#include <cmath>
+#include "philox.h"
+
+using namespace std;
+
+NormalBatch::NormalBatch(long capacity) {
+    reserve(capacity);
+}
+
+void NormalBatch::reserve(long n) {
+    if (static_cast<long>(w1_.size()) >= n) {
+        return;
+    }
+    c0_.resize(n);
+    c1_.resize(n);
+    c2_.resize(n);
+    c3_.resize(n);
+    w1_.resize(n);
+    w2_.resize(n);
+}
+
+void NormalBatch::fill_uniforms(uint64_t seed, long first_path, long n, uint32_t step,
+                                uint32_t stream) {
+    reserve(n);
+    uint32_t* __restrict c0 = c0_.data();
+    uint32_t* __restrict c1 = c1_.data();
+    uint32_t* __restrict c2 = c2_.data();
+    uint32_t* __restrict c3 = c3_.data();
+    for (long m = 0; m < n; ++m) {
+        uint64_t path = static_cast<uint64_t>(first_path + m);
+        c0[m] = step;
+        c1[m] = stream;
+        c2[m] = static_cast<uint32_t>(path);
+        c3[m] = static_cast<uint32_t>(path >> 32);
+    }
+
+    // Philox4x32-10, un tour pour toutes les voies à la fois.
+    Philox4x32::Key key = Philox4x32::key_from_seed(seed);
+    for (int round = 0; round < 10; ++round) {
+        if (round > 0) {
+            key[0] += 0x9E3779B9u;
+            key[1] += 0xBB67AE85u;
+        }
+        const uint32_t k0 = key[0], k1 = key[1];
+        for (long m = 0; m < n; ++m) {
+            uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * c0[m];
+            uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * c2[m];
+            uint32_t x0 = static_cast<uint32_t>(p1 >> 32) ^ c1[m] ^ k0;
+            uint32_t x2 = static_cast<uint32_t>(p0 >> 32) ^ c3[m] ^ k1;
+            c0[m] = x0;
+            c1[m] = static_cast<uint32_t>(p1);
+            c2[m] = x2;
+            c3[m] = static_cast<uint32_t>(p0);
+        }
+    }
+
+    double* __restrict u1 = w1_.data();
+    double* __restrict u2 = w2_.data();
+    for (long m = 0; m < n; ++m) {
+        u1[m] = philox_uniform(c0[m], c1[m]);
+        u2[m] = philox_uniform(c2[m], c3[m]);
+    }
+}
+
+void NormalBatch::fill_independent(uint64_t seed, long first_path, long n, uint32_t step,
+                                   uint32_t stream) {
+    fill_uniforms(seed, first_path, n, step, stream);
+    double* __restrict a = w1_.data();
+    double* __restrict b = w2_.data();
+    // Box-Muller en passes séparées: rayon puis angle.
+    for (long m = 0; m < n; ++m) {
+        a[m] = sqrt(-2.0 * log(a[m]));
+    }
+    for (long m = 0; m < n; ++m) {
+        double angle = 6.283185307179586 * b[m];
+        double radius = a[m];
+        a[m] = radius * cos(angle);
+        b[m] = radius * sin(angle);
+    }
+}
+
+void NormalBatch::fill(uint64_t seed, long first_path, long n, uint32_t step, double rho,
+                       double scale, uint32_t stream) {
+    fill_independent(seed, first_path, n, step, stream);
+    const double rho_bar = sqrt(1 - rho * rho);
+    double* __restrict z1 = w1_.data();
+    double* __restrict z2 = w2_.data();
+    for (long m = 0; m < n; ++m) {
+        double x = z1[m];
+        z1[m] = scale * x;
+        z2[m] = scale * (rho * x + rho_bar * z2[m]);
+    }
+}
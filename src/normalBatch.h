@@ -0,0 +1,40 @@
+#ifndef NORMAL_BATCH_H
+#define NORMAL_BATCH_H
+
+#include <cstdint>
+#include <vector>
+
+// Générateur de normales par lots: pour un pas donné, les compteurs Philox de toutes les
+// trajectoires d'un bloc sont chiffrés en parallèle (structure de tableaux), puis
+// Box-Muller et la corrélation sont appliqués en passes séparées sans branchement.
+// Les tirages sont identiques à ceux de philox_normal_pair(seed, path, step).
+class NormalBatch {
+public:
+    explicit NormalBatch(long capacity = 0);
+
+    // w1 = scale * z1, w2 = scale * (rho z1 + sqrt(1 - rho^2) z2) pour les trajectoires
+    // [first_path, first_path + n) au pas step.
+    void fill(std::uint64_t seed, long first_path, long n, std::uint32_t step, double rho,
+              double scale, std::uint32_t stream = 0);
+
+    // Normales indépendantes z1, z2 seules (sans corrélation ni échelle).
+    void fill_independent(std::uint64_t seed, long first_path, long n, std::uint32_t step,
+                          std::uint32_t stream = 0);
+
+    // Uniformes Philox seules, dans (0, 1): w1 = u1, w2 = u2 (base de Box-Muller).
+    void fill_uniforms(std::uint64_t seed, long first_path, long n, std::uint32_t step,
+                       std::uint32_t stream = 0);
+
+    const double* w1() const { return w1_.data(); }
+    const double* w2() const { return w2_.data(); }
+    double* w1() { return w1_.data(); }
+    double* w2() { return w2_.data(); }
+
+private:
+    void reserve(long n);
+
+    std::vector<std::uint32_t> c0_, c1_, c2_, c3_;
+    std::vector<double> w1_, w2_;
+};
+
+#endif // NORMAL_BATCH_H
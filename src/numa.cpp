@@ -0,0 +1,100 @@
+#include "numa.h"
+#include <pthread.h>
+#include <sched.h>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+namespace {
+
+const char* const kNodeRoot = "/sys/devices/system/node/";
+
+bool read_line(const string& path, string& line) {
+    ifstream in(path);
+    return static_cast<bool>(getline(in, line));
+}
+
+vector<int> allowed_cpus() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    vector<int> cpus;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; ++c) {
+            if (CPU_ISSET(c, &set)) {
+                cpus.push_back(c);
+            }
+        }
+    }
+    if (cpus.empty()) {
+        cpus.push_back(0);
+    }
+    return cpus;
+}
+
+}  // namespace
+
+vector<int> parse_cpu_list(const string& list) {
+    vector<int> cpus;
+    stringstream ss(list);
+    string range;
+    while (getline(ss, range, ',')) {
+        if (range.empty() || range == "\n") {
+            continue;
+        }
+        const size_t dash = range.find('-');
+        const int lo = stoi(range.substr(0, dash));
+        const int hi = dash == string::npos ? lo : stoi(range.substr(dash + 1));
+        for (int c = lo; c <= hi; ++c) {
+            cpus.push_back(c);
+        }
+    }
+    return cpus;
+}
+
+int NumaTopology::cpus() const {
+    int count = 0;
+    for (const vector<int>& node : node_cpus) {
+        count += static_cast<int>(node.size());
+    }
+    return count;
+}
+
+NumaTopology NumaTopology::detect() {
+    const vector<int> allowed = allowed_cpus();
+    NumaTopology topology;
+    string online;
+    if (read_line(string(kNodeRoot) + "online", online)) {
+        for (int node : parse_cpu_list(online)) {
+            string list;
+            if (!read_line(string(kNodeRoot) + "node" + to_string(node) + "/cpulist", list)) {
+                continue;
+            }
+            vector<int> cpus;
+            for (int c : parse_cpu_list(list)) {
+                if (find(allowed.begin(), allowed.end(), c) != allowed.end()) {
+                    cpus.push_back(c);
+                }
+            }
+            // Noeuds sans CPU utilisable (mémoire seule, ou exclus par l'affinité) ignorés.
+            if (!cpus.empty()) {
+                topology.node_cpus.push_back(cpus);
+            }
+        }
+    }
+    if (topology.node_cpus.empty()) {
+        topology.node_cpus.push_back(allowed);
+    }
+    return topology;
+}
+
+bool pin_current_thread(const vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus) {
+        if (c >= 0 && c < CPU_SETSIZE) {
+            CPU_SET(c, &set);
+        }
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
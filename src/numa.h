@@ -0,0 +1,164 @@
+#ifndef NUMA_H
+#define NUMA_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "monteCarlo.h"
+#include "runningStats.h"
+
+// Topologie NUMA lue dans /sys/devices/system/node (sans libnuma): CPU de chaque noeud,
+// restreints à ceux que le processus a le droit d'utiliser. Sans information NUMA, un seul
+// noeud regroupe tous les CPU autorisés.
+struct NumaTopology {
+    std::vector<std::vector<int>> node_cpus;
+
+    static NumaTopology detect();
+
+    int nodes() const { return static_cast<int>(node_cpus.size()); }
+    int cpus() const;
+};
+
+// "0-3,8,10-11" -> {0, 1, 2, 3, 8, 10, 11} (format cpulist du noyau).
+std::vector<int> parse_cpu_list(const std::string& list);
+
+// Fixe le thread appelant sur les CPU donnés; false si le noyau refuse. L'affinité est
+// héritée par les threads que celui-ci créera ensuite: à n'appeler que depuis un thread
+// de travail dédié.
+bool pin_current_thread(const std::vector<int>& cpus);
+
+// Exécute worker(t) pour t = 0..threads - 1, chacun sur un thread créé ici (t = 0 compris),
+// puis les rejoint. Les workers pouvant se fixer sur des CPU, aucun ne tourne sur le thread
+// appelant: son affinité, et celle des threads qu'il créera ensuite (parallel_for,
+// NumaTopology::detect), reste intacte.
+template <typename Worker>
+void run_workers(int threads, const Worker& worker) {
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back(worker, t);
+    }
+    for (std::thread& th : pool) {
+        th.join();
+    }
+}
+
+// Placement des threads et des buffers du Monte Carlo parallèle:
+//  Naive:     threads libres, buffers alloués et initialisés par le thread appelant (tous sur
+//             son noeud), réduction à plat;
+//  Pinned:    threads fixés sur un CPU, noeuds en alternance, buffers toujours alloués par
+//             le thread appelant;
+//  NumaLocal: threads fixés sur leur noeud, buffers et statistiques alloués par chaque
+//             thread (première écriture, donc mémoire locale), blocs de trajectoires
+//             répartis par noeud, réduction hiérarchique thread -> noeud -> global.
+enum class NumaPlacement { Naive, Pinned, NumaLocal };
+
+// Monte Carlo parallèle avec politique de placement. Mêmes blocs et mêmes tirages que
+// heston_mc_parallel; pour Naive et Pinned le résultat lui est identique au bit près. Pour
+// NumaLocal, la réduction se fait d'abord par noeud: le résultat dépend de la topologie
+// (pas du nombre de threads) et ne diffère de heston_mc_parallel qu'aux arrondis près.
+template <typename Payoff>
+MonteCarloResult heston_mc_numa(const HestonParams& p, int N, long M, const Payoff& payoff,
+                                std::uint64_t seed, NumaPlacement placement,
+                                const NumaTopology& topology, int threads = 0,
+                                long block_size = 2048, Scheme scheme = Scheme::Euler) {
+    const long blocks = (M + block_size - 1) / block_size;
+    if (threads <= 0) {
+        threads = std::max(1, topology.cpus());
+    }
+    threads = static_cast<int>(std::min<long>(threads, std::max(1L, blocks)));
+    const int nodes = placement == NumaPlacement::Naive ? 1 : topology.nodes();
+
+    // Thread t: noeud t % nodes, CPU (t / nodes) modulo les CPU du noeud.
+    auto node_of = [&](int t) { return t % nodes; };
+    auto cpu_of = [&](int t) {
+        const std::vector<int>& cpus = topology.node_cpus[node_of(t)];
+        return cpus[(t / nodes) % cpus.size()];
+    };
+
+    if (placement != NumaPlacement::NumaLocal) {
+        // Buffers et statistiques alloués ici, donc sur le noeud du thread appelant.
+        std::vector<std::vector<double>> S(threads, std::vector<double>(block_size));
+        std::vector<std::vector<double>> v(threads, std::vector<double>(block_size));
+        std::vector<RunningStats> block_stats(blocks);
+        std::atomic<long> next(0);
+        auto worker = [&](int t) {
+            if (placement == NumaPlacement::Pinned) {
+                pin_current_thread({cpu_of(t)});
+            }
+            for (long b = next++; b < blocks; b = next++) {
+                const long first = b * block_size;
+                const long n = std::min(block_size, M - first);
+                simulate_block(p, N, seed, first, n, S[t].data(), v[t].data(), scheme);
+                for (long m = 0; m < n; ++m) {
+                    block_stats[b].add(payoff(S[t][m]));
+                }
+            }
+        };
+        run_workers(threads, worker);
+        RunningStats total;
+        for (const RunningStats& s : block_stats) {
+            total.merge(s);
+        }
+        return make_result(total);
+    }
+
+    // NumaLocal: le noeud k traite les blocs [node_first[k], node_first[k + 1]) au prorata de
+    // ses CPU (découpage fixé par la topologie seule), avec au moins un thread par noeud;
+    // chaque thread garde ses (bloc, statistiques) dans sa mémoire locale.
+    threads = std::max(threads, nodes);
+    std::vector<long> node_first(nodes + 1, 0);
+    long cpus_before = 0;
+    for (int k = 0; k < nodes; ++k) {
+        cpus_before += static_cast<long>(topology.node_cpus[k].size());
+        node_first[k + 1] = blocks * cpus_before / topology.cpus();
+    }
+    std::vector<std::atomic<long>> node_next(nodes);
+    for (int k = 0; k < nodes; ++k) {
+        node_next[k] = node_first[k];
+    }
+    std::vector<std::vector<std::pair<long, RunningStats>>> thread_stats(threads);
+
+    auto worker = [&](int t) {
+        const int k = node_of(t);
+        pin_current_thread(topology.node_cpus[k]);
+        std::vector<double> S(block_size), v(block_size);
+        std::vector<std::pair<long, RunningStats>> local;
+        for (long b = node_next[k]++; b < node_first[k + 1]; b = node_next[k]++) {
+            const long first = b * block_size;
+            const long n = std::min(block_size, M - first);
+            simulate_block(p, N, seed, first, n, S.data(), v.data(), scheme);
+            RunningStats stats;
+            for (long m = 0; m < n; ++m) {
+                stats.add(payoff(S[m]));
+            }
+            local.emplace_back(b, stats);
+        }
+        thread_stats[t] = std::move(local);
+    };
+    run_workers(threads, worker);
+
+    // Réduction hiérarchique, chaque niveau dans l'ordre des blocs: déterministe.
+    RunningStats total;
+    for (int k = 0; k < nodes; ++k) {
+        std::vector<std::pair<long, RunningStats>> node_blocks;
+        for (int t = k; t < threads; t += nodes) {
+            node_blocks.insert(node_blocks.end(), thread_stats[t].begin(), thread_stats[t].end());
+        }
+        std::sort(node_blocks.begin(), node_blocks.end(),
+                  [](const std::pair<long, RunningStats>& a,
+                     const std::pair<long, RunningStats>& b) { return a.first < b.first; });
+        RunningStats node_total;
+        for (const std::pair<long, RunningStats>& block : node_blocks) {
+            node_total.merge(block.second);
+        }
+        total.merge(node_total);
+    }
+    return make_result(total);
+}
+
+#endif // NUMA_H
@@ -0,0 +1,86 @@
+#include "observedPaths.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "parallel.h"
+#include "payoffs.h"
+
+using namespace std;
+
+namespace {
+
+// Politique « payoff » qui recopie l'état du bloc dans les colonnes [first, first + n) du
+// PathSet aux dates d'observation; value n'est pas utilisée.
+class ObservationRecorder {
+public:
+    ObservationRecorder(const vector<int>& steps, PathSet& paths, long first)
+        : steps_(steps), paths_(paths), first_(first) {}
+
+    void start(const HestonParams& p, int, long n) {
+        fill(paths_.stock(0) + first_, paths_.stock(0) + first_ + n, p.S0);
+        fill(paths_.variance(0) + first_, paths_.variance(0) + first_ + n, p.v0);
+        next_ = 0;
+    }
+    void observe(int i, long n, const double* S, const double* v) {
+        if (next_ == steps_.size() || steps_[next_] != i) {
+            return;
+        }
+        ++next_;
+        copy(S, S + n, paths_.stock(static_cast<int>(next_)) + first_);
+        copy(v, v + n, paths_.variance(static_cast<int>(next_)) + first_);
+    }
+    double value(long) const { return 0.0; }
+
+private:
+    const vector<int>& steps_;
+    PathSet& paths_;
+    long first_;
+    size_t next_ = 0;
+};
+
+}  // namespace
+
+vector<int> observation_steps(const HestonParams& p, int N, const vector<double>& times) {
+    vector<int> steps;
+    steps.reserve(times.size());
+    for (double t : times) {
+        if (!(t > 0 && t <= p.T * (1 + 1e-12))) {
+            throw invalid_argument("observation times must lie in (0, T]");
+        }
+        int step = static_cast<int>(lround(t / p.T * N));
+        if (step < 1 || (!steps.empty() && step <= steps.back())) {
+            throw invalid_argument("observation times must be increasing on the step grid");
+        }
+        steps.push_back(step);
+    }
+    return steps;
+}
+
+ObservedPaths simulate_observed(const HestonParams& p, int N, long M,
+                                const vector<int>& observation_steps, uint64_t seed,
+                                int threads, long block_size, Scheme scheme) {
+    for (size_t k = 0; k < observation_steps.size(); ++k) {
+        if (observation_steps[k] < 1 || observation_steps[k] > N ||
+            (k > 0 && observation_steps[k] <= observation_steps[k - 1])) {
+            throw invalid_argument("observation steps must be increasing within [1, N]");
+        }
+    }
+    ObservedPaths out;
+    out.steps = observation_steps;
+    for (int step : observation_steps) {
+        out.times.push_back(step * p.T / N);
+    }
+    out.paths = PathSet(static_cast<int>(observation_steps.size()), M);
+
+    const long blocks = (M + block_size - 1) / block_size;
+    parallel_for(0, blocks, threads, [&](long lo, long hi) {
+        vector<double> S(block_size), v(block_size);
+        for (long b = lo; b < hi; ++b) {
+            const long first = b * block_size;
+            const long n = min(block_size, M - first);
+            ObservationRecorder recorder(out.steps, out.paths, first);
+            simulate_payoff_block(p, N, seed, first, n, S.data(), v.data(), scheme, recorder);
+        }
+    });
+    return out;
+}
@@ -0,0 +1,31 @@
+#ifndef OBSERVED_PATHS_H
+#define OBSERVED_PATHS_H
+
+#include <cstdint>
+#include <vector>
+#include "monteCarlo.h"
+#include "pathSet.h"
+
+// Trajectoires conservées aux seules dates d'observation: paths.stock(0) / variance(0) est
+// l'état initial, paths.stock(k) l'état après steps[k - 1] pas (temps times[k - 1]).
+// La mémoire est en O((K + 1) M) au lieu de O((N + 1) M).
+struct ObservedPaths {
+    std::vector<int> steps;     // indices de pas croissants dans [1, N]
+    std::vector<double> times;  // steps[k] * T / N
+    PathSet paths;              // K dates d'observation (+ date 0)
+};
+
+// Indices de pas les plus proches des temps demandés (0 < t <= T, strictement croissants
+// après arrondi sur la grille de N pas); lève std::invalid_argument sinon.
+std::vector<int> observation_steps(const HestonParams& p, int N, const std::vector<double>& times);
+
+// Simule M trajectoires sur la grille fine de N pas (mêmes tirages Philox que
+// simulate_block) en ne stockant (S, v) qu'aux pas observation_steps. Les valeurs stockées
+// sont identiques au bit près à celles de simulate_paths_block aux mêmes dates.
+// Schémas Euler et QE; parallèle par blocs de trajectoires.
+ObservedPaths simulate_observed(const HestonParams& p, int N, long M,
+                                const std::vector<int>& observation_steps, std::uint64_t seed,
+                                int threads = 0, long block_size = 2048,
+                                Scheme scheme = Scheme::Euler);
+
+#endif // OBSERVED_PATHS_H
@@ -0,0 +1,167 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+inline int default_thread_count() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : static_cast<int>(n);
+}
+
+// Découpe [begin, end) en blocs contigus, un par thread; fn(lo, hi) traite un bloc.
+// Avec threads <= 0 on utilise tous les coeurs disponibles.
+template <typename Fn>
+void parallel_for(long begin, long end, int threads, Fn&& fn) {
+    if (threads <= 0) {
+        threads = default_thread_count();
+    }
+    long n = end - begin;
+    if (n <= 0) {
+        return;
+    }
+    threads = static_cast<int>(std::min<long>(threads, n));
+    if (threads == 1) {
+        fn(begin, end);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    long chunk = (n + threads - 1) / threads;
+    for (int t = 1; t < threads; ++t) {
+        long lo = begin + t * chunk;
+        long hi = std::min(end, lo + chunk);
+        if (lo >= hi) {
+            break;
+        }
+        workers.emplace_back([&fn, lo, hi]() { fn(lo, hi); });
+    }
+    fn(begin, std::min(end, begin + chunk));
+    for (std::thread& w : workers) {
+        w.join();
+    }
+}
+
+// Threads persistants pour les boucles qui enchaînent de nombreux parallel_for courts (pas de
+// temps ADI): même découpage en blocs contigus, mais les threads sont créés une fois et
+// réveillés à chaque appel au lieu d'être créés puis joints. Le thread appelant traite le
+// premier bloc; une exception levée par fn est relancée après la fin de tous les blocs.
+class ThreadTeam {
+public:
+    explicit ThreadTeam(int threads) {
+        if (threads <= 0) {
+            threads = default_thread_count();
+        }
+        workers_.reserve(threads - 1);
+        for (int t = 1; t < threads; ++t) {
+            workers_.emplace_back([this, t]() { work(t); });
+        }
+    }
+
+    ~ThreadTeam() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_.notify_all();
+        for (std::thread& w : workers_) {
+            w.join();
+        }
+    }
+
+    ThreadTeam(const ThreadTeam&) = delete;
+    ThreadTeam& operator=(const ThreadTeam&) = delete;
+
+    int size() const { return static_cast<int>(workers_.size()) + 1; }
+
+    template <typename Fn>
+    void parallel_for(long begin, long end, Fn&& fn) {
+        const long n = end - begin;
+        if (n <= 0) {
+            return;
+        }
+        const int used = static_cast<int>(std::min<long>(size(), n));
+        if (used == 1) {
+            fn(begin, end);
+            return;
+        }
+        const long chunk = (n + used - 1) / used;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = [&fn](long lo, long hi) { fn(lo, hi); };
+            begin_ = begin;
+            end_ = end;
+            chunk_ = chunk;
+            pending_ = static_cast<int>(workers_.size());
+            ++generation_;
+        }
+        start_.notify_all();
+        std::exception_ptr error;
+        try {
+            fn(begin, std::min(end, begin + chunk));
+        } catch (...) {
+            error = std::current_exception();
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this]() { return pending_ == 0; });
+        task_ = nullptr;
+        if (!error) {
+            error = error_;
+        }
+        error_ = nullptr;
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    void work(int t) {
+        long seen = 0;
+        for (;;) {
+            long lo, hi;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_.wait(lock, [&]() { return stop_ || generation_ != seen; });
+                if (stop_) {
+                    return;
+                }
+                seen = generation_;
+                lo = begin_ + t * chunk_;
+                hi = std::min(end_, lo + chunk_);
+            }
+            std::exception_ptr error;
+            if (lo < hi) {
+                try {
+                    task_(lo, hi);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (error && !error_) {
+                error_ = error;
+            }
+            if (--pending_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable start_, done_;
+    std::function<void(long, long)> task_;
+    long begin_ = 0, end_ = 0, chunk_ = 0;
+    long generation_ = 0;
+    int pending_ = 0;
+    bool stop_ = false;
+    std::exception_ptr error_;
+};
+
+#endif // PARALLEL_H
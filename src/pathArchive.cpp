@@ -0,0 +1,158 @@
+#include "pathArchive.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include "parallel.h"
+
+using namespace std;
+
+namespace {
+
+constexpr char kMagic[8] = {'H', 'E', 'S', 'T', 'P', 'A', 'T', 'H'};
+
+[[noreturn]] void io_error(const string& what, const string& filename) {
+    throw runtime_error(what + " " + filename + ": " + strerror(errno));
+}
+
+// Descripteur fermé à la sortie de portée, y compris sur exception.
+struct FileDescriptor {
+    int fd;
+    ~FileDescriptor() {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+};
+
+// Projection démontée à la sortie de portée, y compris si la simulation lève une exception.
+// Une erreur est signalée (io_error) avant le démontage: munmap ne peut pas écraser errno.
+struct Mapping {
+    void* data;
+    size_t size;
+    ~Mapping() {
+        if (data != MAP_FAILED) {
+            munmap(data, size);
+        }
+    }
+};
+
+}  // namespace
+
+PathArchiveHeader write_path_archive(const string& filename, const HestonParams& p, int N, long M,
+                                     uint64_t seed, Scheme scheme, long chunk_paths,
+                                     int threads) {
+    if (scheme == Scheme::Exact) {
+        throw invalid_argument("path archives require the Euler or QE scheme");
+    }
+    if (N <= 0 || M <= 0 || chunk_paths <= 0) {
+        throw invalid_argument("steps, paths and chunk size must be positive");
+    }
+    const long per_line = PathSet::ALIGNMENT / sizeof(double);
+    PathArchiveHeader header{};
+    header.version = PathArchiveHeader::VERSION;
+    header.steps = N;
+    header.paths = M;
+    header.chunk_paths = (min(chunk_paths, M) + per_line - 1) / per_line * per_line;
+    header.seed = seed;
+    header.scheme = static_cast<int32_t>(scheme);
+    header.params = p;
+
+    FileDescriptor file{open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644)};
+    if (file.fd < 0) {
+        io_error("cannot create", filename);
+    }
+    const size_t size = header.file_bytes();
+    if (ftruncate(file.fd, static_cast<off_t>(size)) != 0) {
+        io_error("cannot resize", filename);
+    }
+    const Mapping map{mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file.fd, 0), size};
+    if (map.data == MAP_FAILED) {
+        io_error("cannot map", filename);
+    }
+    char* base = static_cast<char*>(map.data) + PathArchiveHeader::HEADER_BYTES;
+
+    // Chaque chunk est simulé en place: les écritures vont directement dans le cache de pages.
+    parallel_for(0, header.chunks(), threads, [&](long lo, long hi) {
+        for (long c = lo; c < hi; ++c) {
+            double* S = reinterpret_cast<double*>(base + c * header.chunk_bytes());
+            double* v = S + static_cast<long>(N + 1) * header.chunk_paths;
+            const long first = c * header.chunk_paths;
+            const long n = min(header.chunk_paths, M - first);
+            simulate_paths_block(p, N, seed, first, n, S, v, header.chunk_paths, scheme);
+        }
+    });
+
+    // La signature est écrite en dernier, une fois les données sur disque: une archive
+    // interrompue, même par un arrêt brutal, est rejetée à la lecture.
+    if (msync(map.data, size, MS_SYNC) != 0) {
+        io_error("cannot write", filename);
+    }
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    memcpy(map.data, &header, sizeof(header));
+    if (msync(map.data, PathArchiveHeader::HEADER_BYTES, MS_SYNC) != 0) {
+        io_error("cannot write header of", filename);
+    }
+    return header;
+}
+
+PathArchive::PathArchive(const string& filename) {
+    FileDescriptor file{open(filename.c_str(), O_RDONLY)};
+    if (file.fd < 0) {
+        io_error("cannot open", filename);
+    }
+    struct stat info;
+    if (fstat(file.fd, &info) != 0) {
+        io_error("cannot stat", filename);
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    if (size_ < PathArchiveHeader::HEADER_BYTES) {
+        throw runtime_error("truncated path archive " + filename);
+    }
+    map_ = mmap(nullptr, size_, PROT_READ, MAP_SHARED, file.fd, 0);
+    if (map_ == MAP_FAILED) {
+        map_ = nullptr;
+        io_error("cannot map", filename);
+    }
+    memcpy(&header_, map_, sizeof(header_));
+    const bool valid = memcmp(header_.magic, kMagic, sizeof(kMagic)) == 0 &&
+                       header_.version == PathArchiveHeader::VERSION && header_.steps > 0 &&
+                       header_.paths > 0 && header_.chunk_paths > 0 &&
+                       header_.file_bytes() <= size_;
+    if (!valid) {
+        munmap(map_, size_);
+        map_ = nullptr;
+        throw runtime_error("invalid path archive " + filename);
+    }
+}
+
+PathArchive::~PathArchive() {
+    if (map_) {
+        munmap(map_, size_);
+    }
+}
+
+const double* PathArchive::chunk(long c) const {
+    const char* base = static_cast<const char*>(map_) + PathArchiveHeader::HEADER_BYTES;
+    return reinterpret_cast<const double*>(base + c * header_.chunk_bytes());
+}
+
+StepView PathArchive::step(long c, int i) const {
+    const long row = header_.chunk_paths;
+    const double* S = chunk(c);
+    const double* v = S + static_cast<long>(header_.steps + 1) * row;
+    const long n = min(row, paths() - c * row);
+    return {S + static_cast<long>(i) * row, v + static_cast<long>(i) * row, n};
+}
+
+PathView PathArchive::path(long m) const {
+    const long row = header_.chunk_paths;
+    const int dates = header_.steps + 1;
+    const double* S = chunk(m / row) + m % row;
+    const double* v = S + static_cast<long>(dates) * row;
+    return {{S, row, dates}, {v, row, dates}};
+}
@@ -0,0 +1,90 @@
+#ifndef PATH_ARCHIVE_H
+#define PATH_ARCHIVE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "monteCarlo.h"
+#include "pathSet.h"
+
+// En-tête binaire d'une archive de trajectoires (octets natifs, petit-boutiste sur x86).
+// Le fichier commence par une page de HEADER_BYTES octets, suivie de chunks de taille fixe:
+// chunk c = trajectoires [c * chunk_paths, (c + 1) * chunk_paths), stockées comme un
+// PathSet: S[date][k] pour toutes les dates, puis v[date][k]. Le dernier chunk est complet
+// sur disque; seules ses paths - c * chunk_paths premières colonnes sont valides.
+struct PathArchiveHeader {
+    static constexpr std::size_t HEADER_BYTES = 4096;
+    static constexpr std::uint32_t VERSION = 1;
+
+    char magic[8];             // "HESTPATH"
+    std::uint32_t version;
+    std::int32_t steps;        // N: dates 0..N
+    std::int64_t paths;        // M
+    std::int64_t chunk_paths;  // multiple de 8 (lignes alignées sur 64 octets)
+    std::uint64_t seed;
+    std::int32_t scheme;       // static_cast<int>(Scheme)
+    std::int32_t reserved;
+    HestonParams params;
+
+    long chunks() const { return static_cast<long>((paths + chunk_paths - 1) / chunk_paths); }
+    std::size_t chunk_bytes() const {
+        return 2 * static_cast<std::size_t>(steps + 1) * chunk_paths * sizeof(double);
+    }
+    std::size_t file_bytes() const { return HEADER_BYTES + chunks() * chunk_bytes(); }
+};
+
+// Simule M trajectoires (mêmes tirages Philox que simulate_block) directement dans le
+// fichier filename projeté en mémoire, chunk par chunk et en parallèle: aucune copie en RAM
+// au-delà des pages en cours d'écriture, que le noyau réécrit sur disque au fil de l'eau.
+// Schémas Euler et QE. Lève std::runtime_error en cas d'erreur d'entrée-sortie.
+PathArchiveHeader write_path_archive(const std::string& filename, const HestonParams& p, int N,
+                                     long M, std::uint64_t seed, Scheme scheme = Scheme::Euler,
+                                     long chunk_paths = 4096, int threads = 0);
+
+// Lecture sans copie d'une archive: le fichier est projeté en lecture seule et les vues
+// pointent directement dans la projection. Non copiable; les vues restent valides tant que
+// l'objet existe.
+class PathArchive {
+public:
+    explicit PathArchive(const std::string& filename);
+    ~PathArchive();
+    PathArchive(const PathArchive&) = delete;
+    PathArchive& operator=(const PathArchive&) = delete;
+
+    const PathArchiveHeader& header() const { return header_; }
+    const HestonParams& params() const { return header_.params; }
+    int steps() const { return header_.steps; }
+    long paths() const { return header_.paths; }
+    long chunks() const { return header_.chunks(); }
+    long chunk_paths() const { return header_.chunk_paths; }
+
+    // Date i des trajectoires du chunk c (pas unitaire, size = trajectoires valides).
+    StepView step(long chunk, int i) const;
+    // Trajectoire m à travers les dates (pas de chunk_paths doubles).
+    PathView path(long m) const;
+
+    // Parcourt la date i chunk par chunk: fn(first_path, StepView).
+    template <typename Fn>
+    void for_each_step(int i, Fn&& fn) const {
+        for (long c = 0; c < chunks(); ++c) {
+            fn(c * chunk_paths(), step(c, i));
+        }
+    }
+
+    // Parcourt toutes les trajectoires dans l'ordre: fn(m, PathView).
+    template <typename Fn>
+    void for_each_path(Fn&& fn) const {
+        for (long m = 0; m < paths(); ++m) {
+            fn(m, path(m));
+        }
+    }
+
+private:
+    const double* chunk(long c) const;
+
+    PathArchiveHeader header_;
+    void* map_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+#endif // PATH_ARCHIVE_H
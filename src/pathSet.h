@@ -0,0 +1,78 @@
+#ifndef PATH_SET_H
+#define PATH_SET_H
+
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+// Vue à pas constant sur un tableau contigu (une trajectoire dans un stockage par date).
+struct StridedView {
+    const double* data;
+    long stride;
+    int size;
+
+    double operator[](int i) const { return data[i * stride]; }
+};
+
+// Toutes les trajectoires à une date donnée: accès de pas unitaire.
+struct StepView {
+    const double* S;
+    const double* v;
+    long size;
+};
+
+// Une trajectoire (S, v) lue à travers les dates, sans copie.
+struct PathView {
+    StridedView S;
+    StridedView v;
+};
+
+// Ensemble de trajectoires stocké dans un unique buffer aligné, par date puis par
+// trajectoire: S[i][m] puis v[i][m], chaque ligne étant alignée sur 64 octets.
+class PathSet {
+public:
+    static constexpr std::size_t ALIGNMENT = 64;
+
+    PathSet() = default;
+
+    PathSet(int steps, long paths) : dates_(steps + 1), paths_(paths) {
+        const long per_line = ALIGNMENT / sizeof(double);
+        row_ = (paths + per_line - 1) / per_line * per_line;
+        std::size_t bytes = 2 * static_cast<std::size_t>(dates_) * row_ * sizeof(double);
+        if (bytes == 0) {
+            return;
+        }
+        data_.reset(static_cast<double*>(std::aligned_alloc(ALIGNMENT, bytes)));
+        if (!data_) {
+            throw std::bad_alloc();
+        }
+    }
+
+    int dates() const { return dates_; }
+    int steps() const { return dates_ - 1; }
+    long paths() const { return paths_; }
+    long stride() const { return row_; }
+
+    double* stock(int i) { return data_.get() + static_cast<long>(i) * row_; }
+    const double* stock(int i) const { return data_.get() + static_cast<long>(i) * row_; }
+    double* variance(int i) { return stock(i) + static_cast<long>(dates_) * row_; }
+    const double* variance(int i) const { return stock(i) + static_cast<long>(dates_) * row_; }
+
+    StepView step(int i) const { return {stock(i), variance(i), paths_}; }
+
+    PathView path(long m) const {
+        return {{stock(0) + m, row_, dates_}, {variance(0) + m, row_, dates_}};
+    }
+
+private:
+    struct FreeDeleter {
+        void operator()(double* p) const { std::free(p); }
+    };
+
+    std::unique_ptr<double[], FreeDeleter> data_;
+    int dates_ = 0;
+    long paths_ = 0;
+    long row_ = 0;
+};
+
+#endif // PATH_SET_H
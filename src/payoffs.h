@@ -0,0 +1,206 @@
+#ifndef PAYOFFS_H
+#define PAYOFFS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "monteCarlo.h"
+#include "parallel.h"
+#include "runningStats.h"
+
+// Politiques de payoff évaluées pendant la propagation des trajectoires: ni stockage ni
+// seconde passe. Une politique fournit
+//   void start(const HestonParams& p, int N, long n);          // nouveau bloc de n trajectoires
+//   void observe(int i, long n, const double* S, const double* v);  // dates i = 1..N
+//   double value(long m) const;                                // payoff de la trajectoire m
+// Le moteur en copie un exemplaire par thread: l'état du bloc (tableaux) vit dans la
+// politique et les appels sont résolus à la compilation.
+
+// Call asiatique arithmétique sur les dates 1..N.
+class ArithmeticAsianCall {
+public:
+    explicit ArithmeticAsianCall(double strike) : strike_(strike) {}
+
+    void start(const HestonParams&, int N, long n) {
+        dates_ = N;
+        sum_.assign(n, 0.0);
+    }
+    void observe(int, long n, const double* S, const double*) {
+        for (long m = 0; m < n; ++m) {
+            sum_[m] += S[m];
+        }
+    }
+    double value(long m) const { return std::max(sum_[m] / dates_ - strike_, 0.0); }
+
+private:
+    double strike_;
+    int dates_ = 0;
+    std::vector<double> sum_;
+};
+
+enum class BarrierType { UpAndOut, DownAndOut };
+
+// Call à barrière désactivante surveillée en continu: entre deux dates, ln S est un pont
+// brownien de variance v_{i-1} dt (celle du pas d'Euler), dont la probabilité de ne pas
+// toucher la barrière est 1 - exp(-2 ln(B/S_{i-1}) ln(B/S_i) / (v_{i-1} dt)). Le payoff
+// est pondéré par le produit de ces probabilités, ce qui supprime le biais de surveillance
+// discrète et lisse l'estimateur.
+template <BarrierType Type>
+class BarrierCall {
+public:
+    BarrierCall(double strike, double barrier) : strike_(strike), log_barrier_(std::log(barrier)) {}
+
+    void start(const HestonParams& p, int N, long n) {
+        dt_ = p.T / N;
+        survival_.assign(n, alive(std::log(p.S0)) ? 1.0 : 0.0);
+        log_S_.assign(n, std::log(p.S0));
+        v_.assign(n, p.v0);
+        S_T_.assign(n, p.S0);
+    }
+    void observe(int, long n, const double* S, const double* v) {
+        for (long m = 0; m < n; ++m) {
+            const double log_S = std::log(S[m]);
+            const double a = distance(log_S_[m]);
+            const double b = distance(log_S);
+            const double var = std::max(v_[m], 0.0) * dt_;
+            double survive = 0;
+            if (a > 0 && b > 0) {
+                survive = var > 0 ? 1 - std::exp(-2 * a * b / var) : 1.0;
+            }
+            survival_[m] *= survive;
+            log_S_[m] = log_S;
+            v_[m] = v[m];
+            S_T_[m] = S[m];
+        }
+    }
+    double value(long m) const { return survival_[m] * std::max(S_T_[m] - strike_, 0.0); }
+
+private:
+    double distance(double log_S) const {
+        return Type == BarrierType::UpAndOut ? log_barrier_ - log_S : log_S - log_barrier_;
+    }
+    bool alive(double log_S) const { return distance(log_S) > 0; }
+
+    double strike_;
+    double log_barrier_;
+    double dt_ = 0;
+    std::vector<double> survival_, log_S_, v_, S_T_;
+};
+
+// Call lookback à strike flottant, S_T - min_i S_i sur les dates 0..N (surveillance discrète).
+class FloatingLookbackCall {
+public:
+    void start(const HestonParams& p, int, long n) {
+        min_.assign(n, p.S0);
+        S_T_.assign(n, p.S0);
+    }
+    void observe(int, long n, const double* S, const double*) {
+        for (long m = 0; m < n; ++m) {
+            min_[m] = std::min(min_[m], S[m]);
+            S_T_[m] = S[m];
+        }
+    }
+    double value(long m) const { return S_T_[m] - min_[m]; }
+
+private:
+    std::vector<double> min_, S_T_;
+};
+
+// Cliquet: somme sur periods périodes égales des rendements S_k / S_{k-1} - 1 bornés à
+// [local_floor, local_cap], avec un plancher global. N doit être multiple de periods.
+class Cliquet {
+public:
+    Cliquet(int periods, double local_floor, double local_cap, double global_floor)
+        : periods_(periods),
+          local_floor_(local_floor),
+          local_cap_(local_cap),
+          global_floor_(global_floor) {}
+
+    void start(const HestonParams& p, int N, long n) {
+        if (periods_ <= 0 || N % periods_ != 0) {
+            throw std::invalid_argument("cliquet periods must divide the number of steps");
+        }
+        steps_per_period_ = N / periods_;
+        reset_.assign(n, p.S0);
+        sum_.assign(n, 0.0);
+    }
+    void observe(int i, long n, const double* S, const double*) {
+        if (i % steps_per_period_ != 0) {
+            return;
+        }
+        for (long m = 0; m < n; ++m) {
+            const double ret = S[m] / reset_[m] - 1;
+            sum_[m] += std::min(local_cap_, std::max(local_floor_, ret));
+            reset_[m] = S[m];
+        }
+    }
+    double value(long m) const { return std::max(global_floor_, sum_[m]); }
+
+private:
+    int periods_;
+    double local_floor_, local_cap_, global_floor_;
+    int steps_per_period_ = 1;
+    std::vector<double> reset_, sum_;
+};
+
+// Propage un bloc (mêmes tirages Philox que simulate_block) en appelant payoff.observe
+// après chaque pas, tant que les valeurs du pas sont encore en cache.
+template <typename Payoff>
+void simulate_payoff_block(const HestonParams& p, int N, std::uint64_t seed, long first_path,
+                           long n, double* S, double* v, Scheme scheme, Payoff& payoff) {
+    payoff.start(p, N, n);
+    step_block(p, N, seed, first_path, n, false, S, v, scheme,
+               [&](int i, const double* S_i, const double* v_i) {
+                   payoff.observe(i, n, S_i, v_i);
+               });
+}
+
+// Version antithétique de simulate_payoff_block: pairs paires, la trajectoire pairs + k
+// utilisant les tirages opposés de la trajectoire k (mêmes tirages que
+// simulate_antithetic_block). La politique observe les 2 pairs trajectoires à chaque pas.
+template <typename Payoff>
+void simulate_antithetic_payoff_block(const HestonParams& p, int N, std::uint64_t seed,
+                                      long first_pair, long pairs, double* S, double* v,
+                                      Scheme scheme, Payoff& payoff) {
+    const long n = 2 * pairs;
+    payoff.start(p, N, n);
+    step_block(p, N, seed, first_pair, n, true, S, v, scheme,
+               [&](int i, const double* S_i, const double* v_i) {
+                   payoff.observe(i, n, S_i, v_i);
+               });
+}
+
+// Monte Carlo d'un payoff dépendant du chemin, politique résolue à la compilation.
+// Mêmes blocs et même réduction que heston_mc_parallel: résultat indépendant du nombre de
+// threads. Mémoire O(block_size) quel que soit N.
+template <typename Payoff>
+MonteCarloResult heston_mc_payoff(const HestonParams& p, int N, long M, const Payoff& payoff,
+                                  std::uint64_t seed, int threads = 0, long block_size = 2048,
+                                  Scheme scheme = Scheme::Euler) {
+    static_assert(std::is_copy_constructible<Payoff>::value,
+                  "payoff policies are copied once per thread");
+    const long blocks = (M + block_size - 1) / block_size;
+    std::vector<RunningStats> block_stats(blocks);
+    parallel_for(0, blocks, threads, [&](long lo, long hi) {
+        Payoff local = payoff;
+        std::vector<double> S(block_size), v(block_size);
+        for (long b = lo; b < hi; ++b) {
+            const long first = b * block_size;
+            const long n = std::min(block_size, M - first);
+            simulate_payoff_block(p, N, seed, first, n, S.data(), v.data(), scheme, local);
+            for (long m = 0; m < n; ++m) {
+                block_stats[b].add(local.value(m));
+            }
+        }
+    });
+    RunningStats total;
+    for (const RunningStats& s : block_stats) {
+        total.merge(s);
+    }
+    return make_result(total);
+}
+
+#endif // PAYOFFS_H
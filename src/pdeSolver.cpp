@@ -0,0 +1,407 @@
+#include "pdeSolver.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "parallel.h"
+
+using namespace std;
+
+namespace {
+
+// Poids des différences finies centrées sur grille non uniforme (points i-1, i, i+1).
+struct Stencil {
+    double lo, mid, hi;
+};
+
+Stencil first_derivative(double hm, double hp) {
+    return {-hp / (hm * (hm + hp)), (hp - hm) / (hm * hp), hm / (hp * (hm + hp))};
+}
+
+Stencil second_derivative(double hm, double hp) {
+    return {2.0 / (hm * (hm + hp)), -2.0 / (hm * hp), 2.0 / (hp * (hm + hp))};
+}
+
+// Largeur des blocs de colonnes traités ensemble lors des balayages en v.
+constexpr int COLUMN_BLOCK = 16;
+
+// Discrétisation A = A0 (terme croisé) + A1 (direction S) + A2 (direction v) sur la grille
+// complète; les noeuds de Dirichlet (S = 0, v = v_max) portent leur valeur au bord.
+struct HestonOperator {
+    const vector<double>& s;
+    const vector<double>& v;
+    double kappa, theta, sigma, rho, r;
+    int ns, nv;
+    vector<Stencil> d1s, d2s, d1v, d2v;
+    ThreadTeam& team;
+
+    HestonOperator(const vector<double>& s, const vector<double>& v, double kappa, double theta,
+                   double sigma, double rho, double r, ThreadTeam& team)
+        : s(s),
+          v(v),
+          kappa(kappa),
+          theta(theta),
+          sigma(sigma),
+          rho(rho),
+          r(r),
+          ns(static_cast<int>(s.size())),
+          nv(static_cast<int>(v.size())),
+          d1s(ns),
+          d2s(ns),
+          d1v(nv),
+          d2v(nv),
+          team(team) {
+        for (int i = 1; i < ns - 1; ++i) {
+            d1s[i] = first_derivative(s[i] - s[i - 1], s[i + 1] - s[i]);
+            d2s[i] = second_derivative(s[i] - s[i - 1], s[i + 1] - s[i]);
+        }
+        for (int j = 1; j < nv - 1; ++j) {
+            d1v[j] = first_derivative(v[j] - v[j - 1], v[j + 1] - v[j]);
+            d2v[j] = second_derivative(v[j] - v[j - 1], v[j + 1] - v[j]);
+            // Décentrage amont pour les grandes variances où la dérive domine la diffusion.
+            if (v[j] > 1.0 && theta < v[j]) {
+                double hm = v[j] - v[j - 1];
+                d1v[j] = {-1.0 / hm, 1.0 / hm, 0.0};
+            }
+        }
+    }
+
+    // Coefficients de la ligne i de A1 pour la variance v_j (lo -> i-1, hi -> i+1).
+    Stencil row_s(int i, int j) const {
+        double a = 0.5 * s[i] * s[i] * v[j];
+        if (i == ns - 1) {
+            double h = s[i] - s[i - 1];
+            return {2.0 * a / (h * h), -2.0 * a / (h * h) - 0.5 * r, 0.0};
+        }
+        double b = r * s[i];
+        return {a * d2s[i].lo + b * d1s[i].lo, a * d2s[i].mid + b * d1s[i].mid - 0.5 * r,
+                a * d2s[i].hi + b * d1s[i].hi};
+    }
+
+    // Terme constant de A1 dû à la condition de Neumann u_S = 1 en S_max.
+    double neumann_s(int j) const {
+        int i = ns - 1;
+        double h = s[i] - s[i - 1];
+        return s[i] * s[i] * v[j] / h + r * s[i];
+    }
+
+    Stencil row_v(int j) const {
+        if (j == 0) {
+            double h = v[1] - v[0];
+            return {0.0, -kappa * theta / h - 0.5 * r, kappa * theta / h};
+        }
+        double c = 0.5 * sigma * sigma * v[j];
+        double e = kappa * (theta - v[j]);
+        return {c * d2v[j].lo + e * d1v[j].lo, c * d2v[j].mid + e * d1v[j].mid - 0.5 * r,
+                c * d2v[j].hi + e * d1v[j].hi};
+    }
+
+    // F(U) = A U + b sur les inconnues (i >= 1, j < nv - 1), 0 ailleurs.
+    void apply(const vector<double>& U, vector<double>& out) const {
+        team.parallel_for(0, nv - 1, [&](long j0, long j1) {
+            for (int j = static_cast<int>(j0); j < j1; ++j) {
+                const double* u = &U[j * ns];
+                double* o = &out[j * ns];
+                o[0] = 0.0;
+                Stencil cv = row_v(j);
+                const double* um = j > 0 ? &U[(j - 1) * ns] : u;
+                const double* up = &U[(j + 1) * ns];
+                for (int i = 1; i < ns; ++i) {
+                    Stencil cs = row_s(i, j);
+                    double a1 = cs.lo * u[i - 1] + cs.mid * u[i];
+                    if (i < ns - 1) {
+                        a1 += cs.hi * u[i + 1];
+                    }
+                    double a2 = cv.lo * um[i] + cv.mid * u[i] + cv.hi * up[i];
+                    o[i] = a1 + a2;
+                }
+                o[ns - 1] += neumann_s(j);
+                if (j == 0) {
+                    continue;
+                }
+                // Terme croisé rho sigma S v u_Sv (nul en v = 0 et sur le bord de Neumann).
+                const Stencil& gv = d1v[j];
+                for (int i = 1; i < ns - 1; ++i) {
+                    const Stencil& gs = d1s[i];
+                    double dm = gs.lo * um[i - 1] + gs.mid * um[i] + gs.hi * um[i + 1];
+                    double d0 = gs.lo * u[i - 1] + gs.mid * u[i] + gs.hi * u[i + 1];
+                    double dp = gs.lo * up[i - 1] + gs.mid * up[i] + gs.hi * up[i + 1];
+                    o[i] += rho * sigma * s[i] * v[j] * (gv.lo * dm + gv.mid * d0 + gv.hi * dp);
+                }
+            }
+        });
+    }
+};
+
+// Facteurs (I - w A1_j) pour chaque ligne j et (I - w A2), commun à toutes les colonnes.
+struct ImplicitFactors {
+    vector<TridiagonalSystem> s_lines;
+    TridiagonalSystem v_lines;
+
+    ImplicitFactors(const HestonOperator& A, double w) {
+        int m1 = A.ns - 1, m2 = A.nv - 1;
+        s_lines.resize(m2);
+        for (int j = 0; j < m2; ++j) {
+            vector<double> lo(m1), di(m1), hi(m1);
+            for (int k = 0; k < m1; ++k) {
+                Stencil c = A.row_s(k + 1, j);
+                lo[k] = -w * c.lo;
+                di[k] = 1.0 - w * c.mid;
+                hi[k] = -w * c.hi;
+            }
+            s_lines[j] = TridiagonalSystem(lo, di, hi);
+        }
+        vector<double> lo(m2), di(m2), hi(m2);
+        for (int j = 0; j < m2; ++j) {
+            Stencil c = A.row_v(j);
+            lo[j] = -w * c.lo;
+            di[j] = 1.0 - w * c.mid;
+            hi[j] = -w * c.hi;
+        }
+        v_lines = TridiagonalSystem(lo, di, hi);
+    }
+
+    // x <- (I - w A1)^{-1} x sur les inconnues, ligne par ligne en parallèle.
+    void solve_s(vector<double>& x, int ns, ThreadTeam& team) const {
+        team.parallel_for(0, static_cast<long>(s_lines.size()), [&](long j0, long j1) {
+            for (long j = j0; j < j1; ++j) {
+                s_lines[j].solve(&x[j * ns + 1]);
+            }
+        });
+    }
+
+    // x <- (I - w A2)^{-1} x, par blocs de colonnes contiguës.
+    void solve_v(vector<double>& x, int ns, ThreadTeam& team) const {
+        long blocks = (ns - 1 + COLUMN_BLOCK - 1) / COLUMN_BLOCK;
+        team.parallel_for(0, blocks, [&](long b0, long b1) {
+            for (long b = b0; b < b1; ++b) {
+                int i0 = 1 + static_cast<int>(b) * COLUMN_BLOCK;
+                int width = min(COLUMN_BLOCK, ns - i0);
+                v_lines.solve_many(&x[i0], ns, width);
+            }
+        });
+    }
+};
+
+}  // namespace
+
+TridiagonalSystem::TridiagonalSystem(vector<double> lower, vector<double> diag,
+                                     vector<double> upper)
+    : lower_(move(lower)), diag_(move(diag)), upper_(move(upper)) {
+    size_t n = diag_.size();
+    if (lower_.size() != n || upper_.size() != n) {
+        throw std::invalid_argument("tridiagonal bands must have the same size");
+    }
+    double pivot = diag_[0];
+    for (size_t k = 0; k < n; ++k) {
+        if (k > 0) {
+            lower_[k] /= pivot;
+            pivot = diag_[k] - lower_[k] * upper_[k - 1];
+        }
+        if (pivot == 0.0) {
+            throw std::runtime_error("singular tridiagonal system");
+        }
+        diag_[k] = 1.0 / pivot;
+    }
+}
+
+void TridiagonalSystem::solve(double* x, long stride) const {
+    int n = size();
+    for (int k = 1; k < n; ++k) {
+        x[k * stride] -= lower_[k] * x[(k - 1) * stride];
+    }
+    x[(n - 1) * stride] *= diag_[n - 1];
+    for (int k = n - 2; k >= 0; --k) {
+        x[k * stride] = (x[k * stride] - upper_[k] * x[(k + 1) * stride]) * diag_[k];
+    }
+}
+
+void TridiagonalSystem::solve_many(double* x, long stride, int width) const {
+    int n = size();
+    for (int k = 1; k < n; ++k) {
+        double* row = x + k * stride;
+        const double* prev = row - stride;
+        const double w = lower_[k];
+        for (int c = 0; c < width; ++c) {
+            row[c] -= w * prev[c];
+        }
+    }
+    {
+        double* row = x + (n - 1) * stride;
+        for (int c = 0; c < width; ++c) {
+            row[c] *= diag_[n - 1];
+        }
+    }
+    for (int k = n - 2; k >= 0; --k) {
+        double* row = x + k * stride;
+        const double* next = row + stride;
+        const double u = upper_[k], d = diag_[k];
+        for (int c = 0; c < width; ++c) {
+            row[c] = (row[c] - u * next[c]) * d;
+        }
+    }
+}
+
+double PDESolution::value_at(const vector<double>& field, double S, double V) const {
+    int ns = static_cast<int>(s.size()), nv = static_cast<int>(v.size());
+    int i = static_cast<int>(upper_bound(s.begin(), s.end(), S) - s.begin()) - 1;
+    int j = static_cast<int>(upper_bound(v.begin(), v.end(), V) - v.begin()) - 1;
+    i = max(0, min(i, ns - 2));
+    j = max(0, min(j, nv - 2));
+    double ws = (S - s[i]) / (s[i + 1] - s[i]);
+    double wv = (V - v[j]) / (v[j + 1] - v[j]);
+    double f00 = field[j * ns + i], f10 = field[j * ns + i + 1];
+    double f01 = field[(j + 1) * ns + i], f11 = field[(j + 1) * ns + i + 1];
+    return (1 - wv) * ((1 - ws) * f00 + ws * f10) + wv * ((1 - ws) * f01 + ws * f11);
+}
+
+HestonPDESolver::HestonPDESolver(double K, double tau, double kappa, double theta, double sigma,
+                                 double rho, double r)
+    : K(K), tau(tau), kappa(kappa), theta(theta), sigma(sigma), rho(rho), r(r) {}
+
+vector<double> HestonPDESolver::s_grid() const {
+    // Grille en sinus hyperbolique concentrée autour du strike.
+    double c = K / 5.0;
+    double s_max = s_max_factor * K;
+    double xi_min = asinh(-K / c), xi_max = asinh((s_max - K) / c);
+    vector<double> s(m1 + 1);
+    for (int i = 0; i <= m1; ++i) {
+        s[i] = K + c * sinh(xi_min + i * (xi_max - xi_min) / m1);
+    }
+    s[0] = 0.0;
+    return s;
+}
+
+vector<double> HestonPDESolver::v_grid() const {
+    double d = v_max / 500.0;
+    double eta_max = asinh(v_max / d);
+    vector<double> v(m2 + 1);
+    for (int j = 0; j <= m2; ++j) {
+        v[j] = d * sinh(j * eta_max / m2);
+    }
+    v[0] = 0.0;
+    return v;
+}
+
+PDESolution HestonPDESolver::solve_call() const {
+    if (m1 < 3 || m2 < 3 || N < 1 || damping_steps < 0) {
+        throw std::invalid_argument("PDE grid too small");
+    }
+    PDESolution sol;
+    sol.s = s_grid();
+    sol.v = v_grid();
+    const vector<double>& s = sol.s;
+    const vector<double>& v = sol.v;
+    const int ns = m1 + 1, nv = m2 + 1;
+    // Une seule équipe de threads pour tout le solve: six balayages parallèles par pas de temps.
+    ThreadTeam team(threads);
+
+    HestonOperator A(s, v, kappa, theta, sigma, rho, r, team);
+
+    vector<double> U(ns * nv);
+    for (int j = 0; j < nv; ++j) {
+        for (int i = 0; i < ns; ++i) {
+            U[j * ns + i] = j == nv - 1 ? s[i] : max(s[i] - K, 0.0);
+        }
+    }
+
+    const double hv_theta = 0.5 + sqrt(3.0) / 6.0;
+    const int damping = min(damping_steps, 2 * N);
+    const double dt_damp = tau / N / 2.0;
+    const int hv_steps = N - (damping + 1) / 2;
+    if (hv_steps < 1) {
+        throw std::invalid_argument("not enough time steps for the damping phase");
+    }
+    const double dt = (tau - damping * dt_damp) / hv_steps;
+    ImplicitFactors douglas(A, dt_damp);
+    ImplicitFactors hv(A, hv_theta * dt);
+
+    vector<double> FU(ns * nv), FY(ns * nv), Y0(ns * nv), Y2(ns * nv), D(ns * nv, 0.0);
+
+    // Seuls les noeuds inconnus (i >= 1, j < nv - 1) évoluent; les bords gardent leur valeur.
+    auto for_unknowns = [&](auto&& f) {
+        for (int j = 0; j < nv - 1; ++j) {
+            for (int i = 1; i < ns; ++i) {
+                f(j * ns + i);
+            }
+        }
+    };
+
+    // Douglas avec theta = 1 sur demi-pas pour amortir la non-régularité du payoff.
+    for (int n = 0; n < damping; ++n) {
+        A.apply(U, FU);
+        for_unknowns([&](int k) {
+            Y0[k] = U[k] + dt_damp * FU[k];
+            D[k] = Y0[k] - U[k];
+        });
+        douglas.solve_s(D, ns, team);
+        douglas.solve_v(D, ns, team);
+        for_unknowns([&](int k) { U[k] += D[k]; });
+    }
+
+    Y0 = U;
+    Y2 = U;
+    for (int n = 0; n < hv_steps; ++n) {
+        A.apply(U, FU);
+        for_unknowns([&](int k) {
+            Y0[k] = U[k] + dt * FU[k];
+            D[k] = Y0[k] - U[k];
+        });
+        hv.solve_s(D, ns, team);
+        hv.solve_v(D, ns, team);
+        for_unknowns([&](int k) { Y2[k] = U[k] + D[k]; });
+
+        A.apply(Y2, FY);
+        for_unknowns([&](int k) {
+            Y0[k] += 0.5 * dt * (FY[k] - FU[k]);
+            D[k] = Y0[k] - Y2[k];
+        });
+        hv.solve_s(D, ns, team);
+        hv.solve_v(D, ns, team);
+        for_unknowns([&](int k) { U[k] = Y2[k] + D[k]; });
+    }
+
+    sol.price = U;
+    sol.delta.assign(ns * nv, 0.0);
+    sol.gamma.assign(ns * nv, 0.0);
+    sol.vega.assign(ns * nv, 0.0);
+    for (int j = 0; j < nv; ++j) {
+        const double* u = &U[j * ns];
+        for (int i = 1; i < ns - 1; ++i) {
+            const Stencil& g1 = A.d1s[i];
+            const Stencil& g2 = A.d2s[i];
+            sol.delta[j * ns + i] = g1.lo * u[i - 1] + g1.mid * u[i] + g1.hi * u[i + 1];
+            sol.gamma[j * ns + i] = g2.lo * u[i - 1] + g2.mid * u[i] + g2.hi * u[i + 1];
+        }
+        sol.delta[j * ns] = (u[1] - u[0]) / (s[1] - s[0]);
+        sol.delta[j * ns + ns - 1] = 1.0;
+        sol.gamma[j * ns] = sol.gamma[j * ns + 1];
+        sol.gamma[j * ns + ns - 1] = sol.gamma[j * ns + ns - 2];
+    }
+    for (int j = 0; j < nv; ++j) {
+        for (int i = 0; i < ns; ++i) {
+            double dv;
+            if (j == 0) {
+                dv = (U[ns + i] - U[i]) / (v[1] - v[0]);
+            } else if (j == nv - 1) {
+                dv = (U[j * ns + i] - U[(j - 1) * ns + i]) / (v[j] - v[j - 1]);
+            } else {
+                Stencil g = first_derivative(v[j] - v[j - 1], v[j + 1] - v[j]);
+                dv = g.lo * U[(j - 1) * ns + i] + g.mid * U[j * ns + i] + g.hi * U[(j + 1) * ns + i];
+            }
+            sol.vega[j * ns + i] = dv;
+        }
+    }
+    return sol;
+}
+
+PDESolution HestonPDESolver::solve_put() const {
+    PDESolution sol = solve_call();
+    const double df = exp(-r * tau);
+    const int ns = static_cast<int>(sol.s.size());
+    for (size_t k = 0; k < sol.price.size(); ++k) {
+        sol.price[k] += K * df - sol.s[k % ns];
+        sol.delta[k] -= 1.0;
+    }
+    return sol;
+}
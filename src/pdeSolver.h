@@ -0,0 +1,59 @@
+#ifndef PDE_SOLVER_H
+#define PDE_SOLVER_H
+
+#include <vector>
+
+// Système tridiagonal factorisé une fois (Thomas) puis résolu pour de nombreux seconds membres.
+class TridiagonalSystem {
+public:
+    TridiagonalSystem() = default;
+    TridiagonalSystem(std::vector<double> lower, std::vector<double> diag,
+                      std::vector<double> upper);
+
+    // Résout en place x <- A^{-1} x, x de taille n avec un pas stride entre les éléments.
+    void solve(double* x, long stride = 1) const;
+
+    // Résout simultanément `width` systèmes dont les inconnues sont contiguës pour une
+    // même ligne (x[k * stride + c], c < width): la boucle interne est vectorisable.
+    void solve_many(double* x, long stride, int width) const;
+
+    int size() const { return static_cast<int>(diag_.size()); }
+
+private:
+    std::vector<double> lower_, diag_, upper_;  // après élimination: diag_ contient 1/pivot
+};
+
+// Prix et grecques sur toute la grille (s_i, v_j), stockés en x[j * s.size() + i].
+struct PDESolution {
+    std::vector<double> s, v;
+    std::vector<double> price, delta, gamma, vega;
+
+    double value_at(const std::vector<double>& field, double S, double V) const;
+};
+
+// Solveur EDP 2D du modèle de Heston (schéma ADI de Hundsdorfer-Verwer) sur grilles
+// non uniformes resserrées autour du strike et de v = 0. Un seul solve donne le prix,
+// delta, gamma et vega (dérivée par rapport à la variance v) en chaque noeud.
+class HestonPDESolver {
+public:
+    double K, tau, kappa, theta, sigma, rho, r;
+    int m1 = 200;               // intervalles en S
+    int m2 = 100;               // intervalles en v
+    int N = 100;                // pas de temps
+    double s_max_factor = 8.0;  // S_max = s_max_factor * K
+    double v_max = 5.0;
+    int damping_steps = 2;      // demi-pas d'Euler implicite (Douglas, theta = 1) au départ
+    int threads = 0;
+
+    HestonPDESolver(double K, double tau, double kappa, double theta, double sigma, double rho,
+                    double r);
+
+    PDESolution solve_call() const;
+    PDESolution solve_put() const;
+
+private:
+    std::vector<double> s_grid() const;
+    std::vector<double> v_grid() const;
+};
+
+#endif // PDE_SOLVER_H
@@ -0,0 +1,111 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+// Générateur à compteur Philox4x32-10 (Salmon et al., 2011): la sortie est une fonction
+// pure de (compteur, clé), ce qui permet d'adresser directement le tirage (graine,
+// trajectoire, pas) sans état partagé entre threads.
+struct Philox4x32 {
+    using Counter = std::array<std::uint32_t, 4>;
+    using Key = std::array<std::uint32_t, 2>;
+
+    static Counter generate(Counter ctr, Key key) {
+        for (int round = 0; round < 10; ++round) {
+            if (round > 0) {
+                key[0] += 0x9E3779B9u;
+                key[1] += 0xBB67AE85u;
+            }
+            std::uint64_t p0 = static_cast<std::uint64_t>(0xD2511F53u) * ctr[0];
+            std::uint64_t p1 = static_cast<std::uint64_t>(0xCD9E8D57u) * ctr[2];
+            std::uint32_t hi0 = static_cast<std::uint32_t>(p0 >> 32);
+            std::uint32_t hi1 = static_cast<std::uint32_t>(p1 >> 32);
+            ctr = {hi1 ^ ctr[1] ^ key[0], static_cast<std::uint32_t>(p1), hi0 ^ ctr[3] ^ key[1],
+                   static_cast<std::uint32_t>(p0)};
+        }
+        return ctr;
+    }
+
+    static Key key_from_seed(std::uint64_t seed) {
+        return {static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)};
+    }
+};
+
+// Répartition des flux Philox (deuxième mot du compteur) entre les moteurs. Deux moteurs
+// qui partageraient un flux tireraient, à graine égale, les mêmes nombres: tout nouveau
+// moteur réserve ici un flux ou une plage libre (5 à 15 et au-delà de 128 + actifs).
+constexpr std::uint32_t STREAM_STEPPING = 0;          // schémas Euler / QE, SLV, LSM
+constexpr std::uint32_t STREAM_EXACT = 1;             // échantillonnage exact
+constexpr std::uint32_t STREAM_SCRAMBLE = 2;          // brouillage Sobol, par réplique
+constexpr std::uint32_t STREAM_SYNTHETIC_PARAMS = 3;  // paramètres du marché synthétique
+constexpr std::uint32_t STREAM_SYNTHETIC_NOISE = 4;   // bruit des prix synthétiques
+constexpr std::uint32_t STREAM_QMC_PADDING = 16;      // + réplique QMC, plage [16, 64)
+constexpr std::uint32_t STREAM_MLMC_LEVEL = 64;       // + niveau MLMC, plage [64, 128)
+constexpr std::uint32_t STREAM_MULTI_ASSET = 128;     // + actif, plage [128, ...)
+
+// Uniforme dans (0, 1) sur 53 bits à partir de deux mots de 32 bits.
+inline double philox_uniform(std::uint32_t hi, std::uint32_t lo) {
+    std::uint64_t bits = (static_cast<std::uint64_t>(hi) << 21) ^ (lo >> 11);
+    return (static_cast<double>(bits & ((1ull << 53) - 1)) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+// Deux normales indépendantes (Box-Muller) pour le tirage (graine, trajectoire, pas, flux).
+inline void philox_normal_pair(std::uint64_t seed, std::uint64_t path, std::uint32_t step,
+                               double& z1, double& z2, std::uint32_t stream = 0) {
+    Philox4x32::Counter out = Philox4x32::generate(
+        {step, stream, static_cast<std::uint32_t>(path), static_cast<std::uint32_t>(path >> 32)},
+        Philox4x32::key_from_seed(seed));
+    double u1 = philox_uniform(out[0], out[1]);
+    double u2 = philox_uniform(out[2], out[3]);
+    double radius = std::sqrt(-2.0 * std::log(u1));
+    double angle = 6.283185307179586 * u2;
+    z1 = radius * std::cos(angle);
+    z2 = radius * std::sin(angle);
+}
+
+// Suite illimitée de tirages pour une trajectoire (algorithmes à rejet, lois discrètes):
+// le k-ième bloc Philox est le compteur {k, flux, trajectoire}, chaque bloc donne deux
+// uniformes. Les flux doivent être distincts de ceux de philox_normal_pair.
+class PhiloxStream {
+public:
+    PhiloxStream(std::uint64_t seed, std::uint64_t path, std::uint32_t stream)
+        : key_(Philox4x32::key_from_seed(seed)),
+          stream_(stream),
+          path_lo_(static_cast<std::uint32_t>(path)),
+          path_hi_(static_cast<std::uint32_t>(path >> 32)) {}
+
+    double uniform() {
+        if (available_ == 0) {
+            block_ = Philox4x32::generate({counter_++, stream_, path_lo_, path_hi_}, key_);
+            available_ = 2;
+        }
+        --available_;
+        return available_ == 1 ? philox_uniform(block_[0], block_[1])
+                               : philox_uniform(block_[2], block_[3]);
+    }
+
+    double normal() {
+        if (has_spare_) {
+            has_spare_ = false;
+            return spare_;
+        }
+        double radius = std::sqrt(-2.0 * std::log(uniform()));
+        double angle = 6.283185307179586 * uniform();
+        spare_ = radius * std::sin(angle);
+        has_spare_ = true;
+        return radius * std::cos(angle);
+    }
+
+private:
+    Philox4x32::Key key_;
+    std::uint32_t stream_, path_lo_, path_hi_;
+    std::uint32_t counter_ = 0;
+    Philox4x32::Counter block_{};
+    int available_ = 0;
+    double spare_ = 0.0;
+    bool has_spare_ = false;
+};
+
+#endif // PHILOX_H
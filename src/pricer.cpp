@@ -1,3 +1,4 @@
+#include "pricer.h"
 #include <time.h>
 #include <algorithm>
 #include <cmath>
@@ -21,6 +22,45 @@ double norm_pdf(double x) {
     return exp(-x * x / 2) / sqrt(2 * PI);
 }
 
+double norm_inv_cdf(double u) {
+    static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02,
+                               -2.759285104469687e+02, 1.383577518672690e+02,
+                               -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02,
+                               -1.556989798598866e+02, 6.680131188771972e+01,
+                               -1.328068155288572e+01};
+    static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01,
+                               -2.400758277161838e+00, -2.549732539343734e+00,
+                               4.374664141464968e+00,  2.938163982698783e+00};
+    static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01,
+                               2.445134137142996e+00, 3.754408661907416e+00};
+    // Symétrie: le raffinement se fait toujours dans la queue gauche, où 1 - u est exact.
+    if (u > 0.5) {
+        return -norm_inv_cdf(1 - u);
+    }
+    const double u_low = 0.02425;
+    double x;
+    if (u < u_low) {
+        double q = sqrt(-2 * log(u));
+        x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+            ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+    } else {
+        double q = u - 0.5, r = q * q;
+        x = (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+            (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+    }
+    // Erreur relative initiale ~1e-9; un pas de Halley amène à la précision machine.
+    double e = norm_cdf(x) - u;
+    double step = e * sqrt(2 * PI) * exp(x * x / 2);
+    return x - step / (1 + x * step / 2);
+}
+
+double black_scholes_call(double S, double K, double tau, double vol, double r) {
+    double sd = vol * sqrt(tau);
+    double d1 = (log(S / K) + (r + 0.5 * vol * vol) * tau) / sd;
+    return S * norm_cdf(d1) - K * exp(-r * tau) * norm_cdf(d1 - sd);
+}
+
 pair<vector<vector<double>>, vector<vector<double>>> HestonSimulation(double S0, double drift,
                                                                       double T, double v0,
                                                                       double kappa, double theta,
@@ -54,142 +94,270 @@ pair<vector<vector<double>>, vector<vector<double>>> HestonSimulation(double S0,
     return make_pair(stock_path, variance_path);
 }
 
-class HestonPricer {
-public:
-    double S, K, tau, v, kappa, theta, sigma, rho, r;
-
-public:
-    HestonPricer(double S, double K, double tau, double v, double kappa, double theta, double sigma,
-                 double rho, double r)
-        : S(S), K(K), tau(tau), v(v), kappa(kappa), theta(theta), sigma(sigma), rho(rho), r(r) {}
-
-    HestonPricer(const HestonPricer& other)
-        : S(other.S),
-          K(other.K),
-          tau(other.tau),
-          v(other.v),
-          kappa(other.kappa),
-          theta(other.theta),
-          sigma(other.sigma),
-          rho(other.rho),
-          r(other.r) {}
-
-    complex<double> characteristic_function(complex<double> u) {
-        complex<double> i(0.0, 1.0);
-        double x = log(S);
-
-        complex<double> d =
-            sqrt(pow(rho * sigma * u * i - kappa, 2.0) + sigma * sigma * (u * i + u * u));
-        complex<double> g = (kappa - rho * sigma * u * i - d) / (kappa - rho * sigma * u * i + d);
-
-        complex<double> C =
-            r * u * i * tau + (kappa * theta) / (sigma * sigma) *
-                                  ((kappa - rho * sigma * u * i - d) * tau -
-                                   2.0 * log((1.0 - g * exp(-d * tau)) / (1.0 - g)));
-        complex<double> D = ((kappa - rho * sigma * u * i - d) / (sigma * sigma)) *
-                            ((1.0 - exp(-d * tau)) / (1.0 - g * exp(-d * tau)));
-
-        return exp(C + D * v + i * u * x);
+PathSet HestonSimulationPaths(double S0, double drift, double T, double v0, double kappa,
+                              double theta, double sigma, double rho, int N, long M) {
+    double dt = T / N;
+    double sqrt_dt = sqrt(dt);
+    double rho_bar = sqrt(1 - rho * rho);
+    PathSet paths(N, M);
+    random_device rd;
+    mt19937 gen(rd());
+    normal_distribution<> dW(0, sqrt_dt);
+    vector<double> z1(M), z2(M);
+
+    fill(paths.stock(0), paths.stock(0) + M, S0);
+    fill(paths.variance(0), paths.variance(0) + M, v0);
+    for (int i = 1; i <= N; i++) {
+        for (long m = 0; m < M; m++) {
+            z1[m] = dW(gen);
+            z2[m] = rho * z1[m] + rho_bar * dW(gen);
+        }
+        // Chaque date met à jour toutes les trajectoires avec un pas unitaire.
+        const double* s_prev = paths.stock(i - 1);
+        const double* v_prev = paths.variance(i - 1);
+        double* s_next = paths.stock(i);
+        double* v_next = paths.variance(i);
+        for (long m = 0; m < M; m++) {
+            double vt_prev = max(0.0, v_prev[m]);
+            double sqrt_v = sqrt(vt_prev);
+            double vt = vt_prev + kappa * (theta - vt_prev) * dt + sigma * sqrt_v * z1[m];
+            v_next[m] = max(0.0, vt);
+            s_next[m] = s_prev[m] * exp((drift - 0.5 * vt_prev) * dt + sqrt_v * z2[m]);
+        }
     }
+    return paths;
+}
 
-    double integral_term(int j) {
-        double du = 0.01;
-        int N_u = 10000;
-        double sum = 0.0;
-        complex<double> i(0.0, 1.0);
-
-        for (int n = 1; n <= N_u; ++n) {
-            double phi = n * du;
-            complex<double> u(phi, 0.0);
-            complex<double> numer;
-
-            if (j == 1) {
-                numer = exp(-i * u * log(K)) * characteristic_function(u - i);
-            } else {
-                numer = exp(-i * u * log(K)) * characteristic_function(u);
-            }
+HestonPricer::HestonPricer(double S, double K, double tau, double v, double kappa, double theta,
+                           double sigma, double rho, double r)
+    : S(S), K(K), tau(tau), v(v), kappa(kappa), theta(theta), sigma(sigma), rho(rho), r(r) {}
 
-            complex<double> integrand = numer / (i * u);
-            sum += real(integrand) * du;
+HestonPricer::HestonPricer(const HestonPricer& other)
+    : S(other.S),
+      K(other.K),
+      tau(other.tau),
+      v(other.v),
+      kappa(other.kappa),
+      theta(other.theta),
+      sigma(other.sigma),
+      rho(other.rho),
+      r(other.r) {}
+
+complex<double> HestonPricer::characteristic_function(complex<double> u) {
+    complex<double> i(0.0, 1.0);
+    double x = log(S);
+
+    complex<double> d =
+        sqrt(pow(rho * sigma * u * i - kappa, 2.0) + sigma * sigma * (u * i + u * u));
+    complex<double> g = (kappa - rho * sigma * u * i - d) / (kappa - rho * sigma * u * i + d);
+
+    complex<double> C =
+        r * u * i * tau + (kappa * theta) / (sigma * sigma) *
+                              ((kappa - rho * sigma * u * i - d) * tau -
+                               2.0 * log((1.0 - g * exp(-d * tau)) / (1.0 - g)));
+    complex<double> D = ((kappa - rho * sigma * u * i - d) / (sigma * sigma)) *
+                        ((1.0 - exp(-d * tau)) / (1.0 - g * exp(-d * tau)));
+
+    return exp(C + D * v + i * u * x);
+}
+
+double HestonPricer::integral_term(int j) {
+    double du = 0.01;
+    int N_u = 10000;
+    double sum = 0.0;
+    complex<double> i(0.0, 1.0);
+
+    for (int n = 1; n <= N_u; ++n) {
+        double phi = n * du;
+        complex<double> u(phi, 0.0);
+        complex<double> numer;
+
+        if (j == 1) {
+            numer = exp(-i * u * log(K)) * characteristic_function(u - i);
+        } else {
+            numer = exp(-i * u * log(K)) * characteristic_function(u);
         }
-        return sum;
-    }
 
-    double price_call() {
-        double P1 = 0.5 * S + (exp(-r * tau) / PI) * integral_term(1);
-        double P2 = K * exp(-r * tau) * (0.5 + (1.0 / PI) * integral_term(0));
-        return P1 - P2;
+        complex<double> integrand = numer / (i * u);
+        sum += real(integrand) * du;
     }
+    return sum;
+}
 
-    double price_put() {
-        double call_price = price_call();
-        return call_price - S + K * exp(-r * tau);
-    }
-};
+double HestonPricer::price_call() {
+    double P1 = 0.5 * S + (exp(-r * tau) / PI) * integral_term(1);
+    double P2 = K * exp(-r * tau) * (0.5 + (1.0 / PI) * integral_term(0));
+    return P1 - P2;
+}
 
-class HestonGreeks : public HestonPricer {
-public:
-    HestonGreeks(double S, double K, double tau, double v, double kappa, double theta, double sigma,
-                 double rho, double r)
-        : HestonPricer(S, K, tau, v, kappa, theta, sigma, rho, r) {}
+double HestonPricer::price_put() {
+    double call_price = price_call();
+    return call_price - S + K * exp(-r * tau);
+}
 
-    HestonPricer choc_stock(double Stock) {
-        return HestonPricer(Stock, K, tau, v, kappa, theta, sigma, rho, r);
-    }
-    HestonPricer choc_vol(double Vol) {
-        return HestonPricer(S, K, tau, Vol, kappa, theta, sigma, rho, r);
-    }
-    HestonPricer choc_time(double Time) {
-        return HestonPricer(S, K, Time, v, kappa, theta, sigma, rho, r);
-    }
-    HestonPricer choc_rho(double Rho) {
-        return HestonPricer(S, K, tau, v, kappa, theta, sigma, Rho, r);
-    }
-    double delta() {
-        double epsilon = 1e-4;
-        double S_plus = S + epsilon;
-        double S_minus = S - epsilon;
-        double call_price_plus = choc_stock(S_plus).price_call();
-        double call_price_minus = choc_stock(S_minus).price_call();
-        return (call_price_plus - call_price_minus) / (2 * epsilon);
+PricingEstimate HestonPricer::price_call_within(chrono::steady_clock::time_point deadline,
+                                                double tolerance) {
+    using clock = chrono::steady_clock;
+    const int coarse_nodes = 32;
+    const int max_nodes = 1 << 14;
+    complex<double> i(0.0, 1.0);
+    double log_K = log(K);
+    const double df = exp(-r * tau);
+
+    // Domaine de integral_term (u_max = 100), doublé tant que l'intégrande n'y est pas
+    // négligeable: aux petites maturités la fonction caractéristique décroît lentement et la
+    // troncature biaiserait le prix bien au-delà de la borne d'erreur de quadrature. La queue
+    // est estimée par |f(u_max)| u_max = |phi(u_max)|.
+    double u_max = 100.0;
+    for (int k = 0; k < 6; ++k) {
+        complex<double> u(u_max, 0.0);
+        double tail = df / PI * (abs(characteristic_function(u - i)) +
+                                 K * abs(characteristic_function(u)));
+        if (tail <= tolerance) {
+            break;
+        }
+        u_max *= 2;
     }
 
-    double gamma() {
-        double epsilon = 1e-4;
-        double S_plus = S + epsilon;
-        double S_minus = S - epsilon;
-        double call_price_plus = choc_stock(S_plus).price_call();
-        double call_price_minus = choc_stock(S_minus).price_call();
-        double call_price = price_call();
-        return (call_price_plus - 2 * call_price + call_price_minus) / (epsilon * epsilon);
+    auto integrands = [&](double phi, double& f1, double& f0) {
+        complex<double> u(phi, 0.0);
+        complex<double> e = exp(-i * u * log_K);
+        f1 = real(e * characteristic_function(u - i) / (i * u));
+        f0 = real(e * characteristic_function(u) / (i * u));
+    };
+
+    // La valeur en u = 0 (forme 0/0) est extrapolée linéairement, 2 f(h) - f(2h); le niveau
+    // grossier est comparé à la règle de pas 2h construite sur ses noeuds pairs.
+    int n = coarse_nodes;
+    double h = u_max / n;
+    clock::time_point start = clock::now();
+    vector<double> g1(n + 1), g0(n + 1);
+    for (int k = 1; k <= n; ++k) {
+        integrands(k * h, g1[k], g0[k]);
     }
 
-    double vega() {
-        double epsilon = 1e-4;
-        double v_plus = v + epsilon;
-        double v_minus = v - epsilon;
-        double call_price_plus = choc_vol(v_plus).price_call();
-        double call_price_minus = choc_vol(v_minus).price_call();
-        return (call_price_plus - 2 * price_call() + call_price_minus) / (epsilon * epsilon);
+    auto trapezoid = [](double step, double origin, double inner, double end) {
+        return step * (0.5 * origin + inner + 0.5 * end);
+    };
+    double inner1 = 0.0, inner0 = 0.0, half1 = 0.0, half0 = 0.0;
+    for (int k = 1; k < n; ++k) {
+        inner1 += g1[k];
+        inner0 += g0[k];
+        if (k % 2 == 0) {
+            half1 += g1[k];
+            half0 += g0[k];
+        }
     }
+    double end1 = g1[n], end0 = g0[n];
+    double first1 = g1[1], first0 = g0[1], second1 = g1[2], second0 = g0[2];
+    double I1 = trapezoid(h, 2 * first1 - second1, inner1, end1);
+    double I0 = trapezoid(h, 2 * first0 - second0, inner0, end0);
+    double coarse1 = trapezoid(2 * h, 2 * g1[2] - g1[4], half1, end1);
+    double coarse0 = trapezoid(2 * h, 2 * g0[2] - g0[4], half0, end0);
+    double error_bound = df / PI * (fabs(I1 - coarse1) + K * fabs(I0 - coarse0));
+    int evaluated = n;
+    int level_nodes = n;
+    clock::duration level_time = clock::now() - start;
 
-    double theta_() {
-        double epsilon = 1e-4;
-        double tau_plus = tau + epsilon;
-        double tau_minus = tau - epsilon;
-        double theta_plus = choc_time(tau_plus).price_call();
-        double theta_minus = choc_time(tau_minus).price_call();
-        return (theta_plus - theta_minus) / (2 * epsilon);
+    while (error_bound > tolerance && 2 * n <= max_nodes) {
+        // Le niveau suivant évalue n nouveaux noeuds: coût extrapolé du niveau précédent.
+        if (clock::now() + level_time * n / level_nodes > deadline) {
+            break;
+        }
+        clock::time_point level_start = clock::now();
+        double step = h / 2;
+        double new1 = 0.0, new0 = 0.0;
+        double f1_first = 0.0, f0_first = 0.0;
+        for (int k = 1; k < 2 * n; k += 2) {
+            double f1, f0;
+            integrands(k * step, f1, f0);
+            new1 += f1;
+            new0 += f0;
+            if (k == 1) {
+                f1_first = f1;
+                f0_first = f0;
+            }
+        }
+        second1 = first1;
+        second0 = first0;
+        first1 = f1_first;
+        first0 = f0_first;
+        inner1 += new1;
+        inner0 += new0;
+        evaluated += n;
+        level_nodes = n;
+        n *= 2;
+        h = step;
+
+        double next1 = trapezoid(h, 2 * first1 - second1, inner1, end1);
+        double next0 = trapezoid(h, 2 * first0 - second0, inner0, end0);
+        error_bound = df / PI * (fabs(next1 - I1) + K * fabs(next0 - I0));
+        I1 = next1;
+        I0 = next0;
+        level_time = clock::now() - level_start;
     }
-};
-
-int main() {
-    shared_ptr<int> p = make_shared<int>(10);
-    shared_ptr<int> q = p;
-    cout << *p << endl;
-    *q = 20;
-    cout << *q << endl;
-    cout << *p << endl;
-    cout << "pointer number: " << p.use_count() << endl;
-    return 0;
-}
\ No newline at end of file
+
+    double P1 = 0.5 * S + (df / PI) * I1;
+    double P2 = K * df * (0.5 + (1.0 / PI) * I0);
+    return {P1 - P2, error_bound, evaluated, error_bound <= tolerance};
+}
+
+PricingEstimate HestonPricer::price_put_within(chrono::steady_clock::time_point deadline,
+                                               double tolerance) {
+    PricingEstimate call = price_call_within(deadline, tolerance);
+    call.price = call.price - S + K * exp(-r * tau);
+    return call;
+}
+
+HestonGreeks::HestonGreeks(double S, double K, double tau, double v, double kappa, double theta,
+                           double sigma, double rho, double r)
+    : HestonPricer(S, K, tau, v, kappa, theta, sigma, rho, r) {}
+
+HestonPricer HestonGreeks::choc_stock(double Stock) {
+    return HestonPricer(Stock, K, tau, v, kappa, theta, sigma, rho, r);
+}
+HestonPricer HestonGreeks::choc_vol(double Vol) {
+    return HestonPricer(S, K, tau, Vol, kappa, theta, sigma, rho, r);
+}
+HestonPricer HestonGreeks::choc_time(double Time) {
+    return HestonPricer(S, K, Time, v, kappa, theta, sigma, rho, r);
+}
+HestonPricer HestonGreeks::choc_rho(double Rho) {
+    return HestonPricer(S, K, tau, v, kappa, theta, sigma, Rho, r);
+}
+double HestonGreeks::delta() {
+    double epsilon = 1e-4;
+    double S_plus = S + epsilon;
+    double S_minus = S - epsilon;
+    double call_price_plus = choc_stock(S_plus).price_call();
+    double call_price_minus = choc_stock(S_minus).price_call();
+    return (call_price_plus - call_price_minus) / (2 * epsilon);
+}
+
+double HestonGreeks::gamma() {
+    double epsilon = 1e-4;
+    double S_plus = S + epsilon;
+    double S_minus = S - epsilon;
+    double call_price_plus = choc_stock(S_plus).price_call();
+    double call_price_minus = choc_stock(S_minus).price_call();
+    double call_price = price_call();
+    return (call_price_plus - 2 * call_price + call_price_minus) / (epsilon * epsilon);
+}
+
+double HestonGreeks::vega() {
+    double epsilon = 1e-4;
+    double v_plus = v + epsilon;
+    double v_minus = v - epsilon;
+    double call_price_plus = choc_vol(v_plus).price_call();
+    double call_price_minus = choc_vol(v_minus).price_call();
+    return (call_price_plus - 2 * price_call() + call_price_minus) / (epsilon * epsilon);
+}
+
+double HestonGreeks::theta_() {
+    double epsilon = 1e-4;
+    double tau_plus = tau + epsilon;
+    double tau_minus = tau - epsilon;
+    double theta_plus = choc_time(tau_plus).price_call();
+    double theta_minus = choc_time(tau_minus).price_call();
+    return (theta_plus - theta_minus) / (2 * epsilon);
+}
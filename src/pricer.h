@@ -0,0 +1,75 @@
+#ifndef PRICER_H
+#define PRICER_H
+
+#include <chrono>
+#include <complex>
+#include <utility>
+#include <vector>
+#include "pathSet.h"
+
+double norm_cdf(double x);
+double norm_pdf(double x);
+// Inverse de norm_cdf sur (0, 1): approximation d'Acklam raffinée par un pas de Halley.
+double norm_inv_cdf(double u);
+
+double black_scholes_call(double S, double K, double tau, double vol, double r);
+
+std::pair<std::vector<std::vector<double>>, std::vector<std::vector<double>>> HestonSimulation(
+    double S0, double drift, double T, double v0, double kappa, double theta, double sigma,
+    double rho, int N, int M);
+
+// Même schéma d'Euler tronqué que HestonSimulation, stocké dans un PathSet contigu.
+PathSet HestonSimulationPaths(double S0, double drift, double T, double v0, double kappa,
+                              double theta, double sigma, double rho, int N, long M);
+
+// Meilleure estimation disponible à l'échéance fixée, avec une borne d'erreur de quadrature.
+struct PricingEstimate {
+    double price;
+    double error_bound;
+    int nodes;       // noeuds de quadrature évalués
+    bool converged;  // error_bound <= tolérance demandée
+};
+
+class HestonPricer {
+public:
+    double S, K, tau, v, kappa, theta, sigma, rho, r;
+
+public:
+    HestonPricer(double S, double K, double tau, double v, double kappa, double theta, double sigma,
+                 double rho, double r);
+
+    HestonPricer(const HestonPricer& other);
+
+    std::complex<double> characteristic_function(std::complex<double> u);
+
+    double integral_term(int j);
+
+    double price_call();
+
+    double price_put();
+
+    // Quadrature trapèze emboîtée (pas divisé par deux à chaque niveau) arrêtée dès que la
+    // tolérance est atteinte ou que le niveau suivant ne tiendrait pas avant l'échéance.
+    PricingEstimate price_call_within(std::chrono::steady_clock::time_point deadline,
+                                      double tolerance = 1e-8);
+    PricingEstimate price_put_within(std::chrono::steady_clock::time_point deadline,
+                                     double tolerance = 1e-8);
+};
+
+class HestonGreeks : public HestonPricer {
+public:
+    HestonGreeks(double S, double K, double tau, double v, double kappa, double theta, double sigma,
+                 double rho, double r);
+
+    HestonPricer choc_stock(double Stock);
+    HestonPricer choc_vol(double Vol);
+    HestonPricer choc_time(double Time);
+    HestonPricer choc_rho(double Rho);
+
+    double delta();
+    double gamma();
+    double vega();
+    double theta_();
+};
+
+#endif // PRICER_H
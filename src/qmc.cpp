@@ -0,0 +1,127 @@
+#include "qmc.h"
+#include <cmath>
+#include <stdexcept>
+#include "philox.h"
+#include "pricer.h"
+
+using namespace std;
+
+BrownianBridge::BrownianBridge(int steps)
+    : steps_(steps),
+      left_(steps),
+      right_(steps),
+      bridge_(steps),
+      left_weight_(steps),
+      right_weight_(steps),
+      std_dev_(steps) {
+    // Points t_l = l + 1 (l = 0..steps-1), W(0) = 0. map[l] != 0: point déjà construit.
+    vector<int> map(steps, 0);
+    map[steps - 1] = 1;
+    bridge_[0] = steps - 1;
+    std_dev_[0] = sqrt(static_cast<double>(steps));
+    for (int i = 1, j = 0; i < steps; ++i) {
+        while (map[j]) {
+            ++j;
+        }
+        int k = j;
+        while (!map[k]) {
+            ++k;
+        }
+        // [j, k) est un intervalle libre borné à droite par k et à gauche par j - 1 (ou 0).
+        int l = j + ((k - 1 - j) >> 1);
+        map[l] = i;
+        bridge_[i] = l;
+        left_[i] = j;
+        right_[i] = k;
+        double t_left = j, t_mid = l + 1, t_right = k + 1;
+        left_weight_[i] = (t_right - t_mid) / (t_right - t_left);
+        right_weight_[i] = (t_mid - t_left) / (t_right - t_left);
+        std_dev_[i] = sqrt((t_mid - t_left) * (t_right - t_mid) / (t_right - t_left));
+        j = k + 1;
+        if (j >= steps) {
+            j = 0;
+        }
+    }
+}
+
+void BrownianBridge::build(const double* z, double* dw) const {
+    // dw sert d'abord à stocker W(t_l), puis est différencié sur place.
+    dw[steps_ - 1] = std_dev_[0] * z[0];
+    for (int i = 1; i < steps_; ++i) {
+        int j = left_[i], k = right_[i], l = bridge_[i];
+        double w_left = j > 0 ? dw[j - 1] : 0.0;
+        dw[l] = left_weight_[i] * w_left + right_weight_[i] * dw[k] + std_dev_[i] * z[i];
+    }
+    for (int l = steps_ - 1; l > 0; --l) {
+        dw[l] -= dw[l - 1];
+    }
+}
+
+void qmc_block(const HestonParams& p, int N, const SobolSequence* sobol,
+               const BrownianBridge* bridge, uint64_t seed, uint32_t replicate, uint64_t first,
+               long n, Scheme scheme, PathSet& paths) {
+    if (scheme == Scheme::Exact) {
+        throw invalid_argument("QMC supports the Euler and QE schemes only");
+    }
+    const int dims = 2 * N;
+    const int sobol_dims = sobol ? sobol->dimension() : 0;
+    const double dt = p.T / N;
+    const double sqrt_dt = sqrt(dt);
+    const double rho_bar = sqrt(1 - p.rho * p.rho);
+
+    // Normales par trajectoire puis, après le pont, par pas: z1 (variance), z2 (sous-jacent).
+    vector<double> u(static_cast<size_t>(n) * max(sobol_dims, 1));
+    vector<double> coords(dims), zv(N), zs(N), dwv(N), dws(N);
+    vector<double> z1(static_cast<size_t>(N) * n), z2(static_cast<size_t>(N) * n);
+    if (sobol) {
+        sobol->generate(first, n, u.data());
+    }
+    for (long m = 0; m < n; ++m) {
+        for (int c = 0; c < sobol_dims; ++c) {
+            coords[c] = norm_inv_cdf(u[m * sobol_dims + c]);
+        }
+        if (sobol_dims < dims) {
+            PhiloxStream rng(seed, first + m, STREAM_QMC_PADDING + replicate);
+            for (int c = sobol_dims; c < dims; ++c) {
+                coords[c] = rng.normal();
+            }
+        }
+        for (int k = 0; k < N; ++k) {
+            zv[k] = coords[2 * k];
+            zs[k] = coords[2 * k + 1];
+        }
+        const double* v_increments = zv.data();
+        const double* s_increments = zs.data();
+        if (bridge) {
+            bridge->build(zv.data(), dwv.data());
+            bridge->build(zs.data(), dws.data());
+            v_increments = dwv.data();
+            s_increments = dws.data();
+        }
+        for (int k = 0; k < N; ++k) {
+            z1[k * n + m] = v_increments[k];
+            z2[k * n + m] = s_increments[k];
+        }
+    }
+
+    fill(paths.stock(0), paths.stock(0) + n, p.S0);
+    fill(paths.variance(0), paths.variance(0) + n, p.v0);
+    vector<double> w1(n), w2(n);
+    for (int i = 1; i <= N; ++i) {
+        double* S = paths.stock(i);
+        double* v = paths.variance(i);
+        copy(paths.stock(i - 1), paths.stock(i - 1) + n, S);
+        copy(paths.variance(i - 1), paths.variance(i - 1) + n, v);
+        const double* a = z1.data() + static_cast<size_t>(i - 1) * n;
+        const double* b = z2.data() + static_cast<size_t>(i - 1) * n;
+        if (scheme == Scheme::QE) {
+            qe_step(p, dt, n, S, v, a, b);
+        } else {
+            for (long m = 0; m < n; ++m) {
+                w1[m] = sqrt_dt * a[m];
+                w2[m] = sqrt_dt * (p.rho * a[m] + rho_bar * b[m]);
+            }
+            euler_step(p, dt, n, S, v, w1.data(), w2.data());
+        }
+    }
+}
@@ -0,0 +1,201 @@
+#include "slv.h"
+#include <cmath>
+#include "normalBatch.h"
+
+using namespace std;
+
+namespace {
+
+// Plancher de E[v | S]: sans condition de Feller, des classes entières de particules ont une
+// variance quasi nulle et le levier exploserait.
+constexpr double kMinConditionalVariance = 1e-4;
+
+// Un pas d'Euler tronqué du modèle SLV; le levier est évalué à la date step_index.
+void slv_step(const HestonParams& p, const LeverageFunction& leverage, int step_index, double dt,
+              long n, double* S, double* v, const double* dW1, const double* dW2) {
+    for (long m = 0; m < n; ++m) {
+        const double vt_prev = max(0.0, v[m]);
+        const double sqrt_v = sqrt(vt_prev);
+        const double l = leverage(step_index, S[m]);
+        const double vt = vt_prev + p.kappa * (p.theta - vt_prev) * dt + p.sigma * sqrt_v * dW1[m];
+        v[m] = max(0.0, vt);
+        S[m] *= exp((p.drift - 0.5 * l * l * vt_prev) * dt + l * sqrt_v * dW2[m]);
+    }
+}
+
+// Sommes partielles d'un bloc de particules: num[k] = sum w v, den[k] = sum w, pos[k] = sum w x.
+struct RegressionSums {
+    vector<double> num, den, pos;
+
+    explicit RegressionSums(int nodes) : num(nodes, 0.0), den(nodes, 0.0), pos(nodes, 0.0) {}
+
+    void merge(const RegressionSums& other) {
+        for (size_t k = 0; k < num.size(); ++k) {
+            num[k] += other.num[k];
+            den[k] += other.den[k];
+            pos[k] += other.pos[k];
+        }
+    }
+};
+
+}  // namespace
+
+double dupire_local_vol(const function<double(double, double)>& call, double r, double T,
+                        double K, double dT, double dK) {
+    const double h = dK * K;
+    const double c = call(T, K);
+    const double up = call(T, K + h), down = call(T, K - h);
+    const double dC_dT = T > dT ? (call(T + dT, K) - call(T - dT, K)) / (2 * dT)
+                                : (call(T + dT, K) - c) / dT;
+    const double dC_dK = (up - down) / (2 * h);
+    const double d2C_dK2 = (up - 2 * c + down) / (h * h);
+    const double variance = (dC_dT + r * K * dC_dK) / (0.5 * K * K * d2C_dK2);
+    return d2C_dK2 > 0 && variance > 0 ? sqrt(variance) : 0.0;
+}
+
+double LeverageFunction::operator()(int i, double S) const {
+    const vector<double>& x = log_spots[i];
+    const vector<double>& y = values[i];
+    const double log_S = log(S);
+    if (log_S <= x.front()) {
+        return y.front();
+    }
+    if (log_S >= x.back()) {
+        return y.back();
+    }
+    const size_t k = upper_bound(x.begin(), x.end(), log_S) - x.begin();
+    const double w = (log_S - x[k - 1]) / (x[k] - x[k - 1]);
+    return y[k - 1] + w * (y[k] - y[k - 1]);
+}
+
+LeverageFunction calibrate_leverage(const HestonParams& p, const LocalVolatility& local_vol,
+                                    const SlvConfig& config) {
+    const long M = config.particles;
+    const int N = config.steps;
+    const double dt = p.T / N;
+    const double sqrt_dt = sqrt(dt);
+    const long blocks = (M + config.block_size - 1) / config.block_size;
+    vector<double> S(M, p.S0), v(M, p.v0), sorted(M);
+
+    LeverageFunction leverage;
+    leverage.dt = dt;
+    for (int i = 0; i < N; ++i) {
+        // Dupire n'est pas défini en t = 0: on l'évalue au milieu du premier pas.
+        const double t = max(i * dt, 0.5 * dt);
+        vector<double> nodes, conditional;
+        if (i == 0) {
+            nodes = {log(p.S0)};
+            conditional = {p.v0};
+        } else {
+            for (long m = 0; m < M; ++m) {
+                sorted[m] = log(S[m]);
+            }
+            sort(sorted.begin(), sorted.end());
+            const int K = config.nodes;
+            // Binning: bornes aux quantiles k / K (classes d'effectifs égaux).
+            // Noyau: K noeuds uniformes entre les quantiles 0,5 % et 99,5 %.
+            const bool binning = config.regression == SlvConfig::Regression::Binning;
+            vector<double> edges(K + 1);
+            for (int k = 0; k <= K; ++k) {
+                edges[k] = sorted[min(M - 1, static_cast<long>(static_cast<double>(k) * M / K))];
+            }
+            const double lo = sorted[static_cast<long>(0.005 * (M - 1))];
+            const double hi = sorted[static_cast<long>(0.995 * (M - 1))];
+            const double spacing = K > 1 ? (hi - lo) / (K - 1) : 1.0;
+            RunningStats spread;
+            for (long m = 0; m < M; m += max(1L, M / 1000)) {
+                spread.add(sorted[m]);
+            }
+            const double h = config.bandwidth * 1.06 * sqrt(spread.variance()) * pow(M, -0.2);
+
+            vector<RegressionSums> partial(blocks, RegressionSums(K));
+            parallel_for(0, blocks, config.threads, [&](long b_lo, long b_hi) {
+                for (long b = b_lo; b < b_hi; ++b) {
+                    RegressionSums& sums = partial[b];
+                    const long end = min(M, (b + 1) * config.block_size);
+                    for (long m = b * config.block_size; m < end; ++m) {
+                        const double x = log(S[m]);
+                        if (binning) {
+                            long k = upper_bound(edges.begin() + 1, edges.end() - 1, x) -
+                                     (edges.begin() + 1);
+                            sums.num[k] += v[m];
+                            sums.den[k] += 1;
+                            sums.pos[k] += x;
+                            continue;
+                        }
+                        // Noyau biweight (1 - u^2)^2 à support [-h, h]: seuls les noeuds
+                        // proches de x sont visités.
+                        const double left = ceil((x - h - lo) / spacing);
+                        const double right = floor((x + h - lo) / spacing);
+                        const int first = static_cast<int>(max(0.0, left));
+                        const int last = static_cast<int>(min(K - 1.0, right));
+                        for (int k = first; k <= last; ++k) {
+                            const double u = (x - (lo + k * spacing)) / h;
+                            const double w = (1 - u * u) * (1 - u * u);
+                            if (u * u < 1) {
+                                sums.num[k] += w * v[m];
+                                sums.den[k] += w;
+                            }
+                        }
+                    }
+                }
+            });
+            RegressionSums total(K);
+            for (const RegressionSums& sums : partial) {
+                total.merge(sums);
+            }
+            for (int k = 0; k < K; ++k) {
+                if (total.den[k] <= 0) {
+                    continue;  // noeud sans particule: ignoré, l'interpolation le comble
+                }
+                const double node = binning ? total.pos[k] / total.den[k] : lo + k * spacing;
+                if (!nodes.empty() && node <= nodes.back()) {
+                    continue;
+                }
+                nodes.push_back(node);
+                conditional.push_back(total.num[k] / total.den[k]);
+            }
+            if (nodes.empty()) {
+                RunningStats all;
+                for (long m = 0; m < M; ++m) {
+                    all.add(v[m]);
+                }
+                nodes = {log(p.S0)};
+                conditional = {all.mean()};
+            }
+        }
+        vector<double> values(nodes.size());
+        for (size_t k = 0; k < nodes.size(); ++k) {
+            values[k] = local_vol(t, exp(nodes[k])) /
+                        sqrt(max(conditional[k], kMinConditionalVariance));
+        }
+        leverage.log_spots.push_back(nodes);
+        leverage.values.push_back(values);
+
+        // Propagation des particules jusqu'à t_{i+1} avec le levier de t_i.
+        parallel_for(0, blocks, config.threads, [&](long b_lo, long b_hi) {
+            thread_local NormalBatch normals;
+            for (long b = b_lo; b < b_hi; ++b) {
+                const long first = b * config.block_size;
+                const long n = min(config.block_size, M - first);
+                normals.fill(config.seed, first, n, i + 1, p.rho, sqrt_dt);
+                slv_step(p, leverage, i, dt, n, S.data() + first, v.data() + first, normals.w1(),
+                         normals.w2());
+            }
+        });
+    }
+    return leverage;
+}
+
+void simulate_slv_block(const HestonParams& p, const LeverageFunction& leverage, uint64_t seed,
+                        long first_path, long n, double* S, double* v) {
+    const double dt = leverage.dt;
+    const double sqrt_dt = sqrt(dt);
+    thread_local NormalBatch normals;
+    fill(S, S + n, p.S0);
+    fill(v, v + n, p.v0);
+    for (int i = 0; i < leverage.steps(); ++i) {
+        normals.fill(seed, first_path, n, i + 1, p.rho, sqrt_dt);
+        slv_step(p, leverage, i, dt, n, S, v, normals.w1(), normals.w2());
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef SLV_H
+#define SLV_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "monteCarlo.h"
+#include "parallel.h"
+#include "runningStats.h"
+
+// Volatilité locale de Dupire sigma_D(t, S) de la nappe de vanilles à reproduire.
+using LocalVolatility = std::function<double(double t, double S)>;
+
+// Volatilité locale de Dupire déduite d'une fonction de prix de call C(T, K) par
+// différences finies centrées: sigma^2 = (dC/dT + r K dC/dK) / (K^2 / 2 d2C/dK2).
+// Chocs: dT en années, dK relatif au strike. Renvoie 0 si la densité est numériquement nulle.
+double dupire_local_vol(const std::function<double(double T, double K)>& call, double r,
+                        double T, double K, double dT = 1e-3, double dK = 1e-2);
+
+// Fonction de levier L(t_i, S) du modèle Heston-SLV, définie sur une grille en ln S par date
+// de pas t_i = i dt, interpolée linéairement en ln S et prolongée par constantes.
+struct LeverageFunction {
+    double dt = 0;
+    std::vector<std::vector<double>> log_spots;  // noeuds croissants à chaque date
+    std::vector<std::vector<double>> values;     // L aux noeuds
+
+    int steps() const { return static_cast<int>(values.size()); }
+    double operator()(int i, double S) const;
+};
+
+struct SlvConfig {
+    enum class Regression { Binning, Kernel };
+
+    int steps = 100;              // pas de temps jusqu'à p.T
+    long particles = 100000;
+    Regression regression = Regression::Kernel;
+    int nodes = 50;               // classes (binning) ou noeuds de la grille (noyau)
+    double bandwidth = 1.5;       // multiplicateur de la règle de Silverman (noyau)
+    std::uint64_t seed = 42;
+    int threads = 0;
+    long block_size = 4096;
+};
+
+// Calibration du levier par la méthode particulaire de Guyon et Henry-Labordère:
+// L(t, S)^2 = sigma_D(t, S)^2 / E[v_t | S_t = S]. Les particules (S, v) sont propagées
+// pas à pas avec le levier de la date courante; l'espérance conditionnelle est estimée
+// à chaque date par classes d'effectifs égaux (binning) ou par régression à noyau biweight
+// de Nadaraya-Watson sur une grille, sommes partielles calculées en parallèle par blocs de
+// particules et réduites dans l'ordre des blocs (résultat indépendant du nombre de threads).
+// Mêmes normales Philox que le schéma d'Euler de simulate_block.
+LeverageFunction calibrate_leverage(const HestonParams& p, const LocalVolatility& local_vol,
+                                    const SlvConfig& config = SlvConfig());
+
+// Propage les trajectoires [first_path, first_path + n) du modèle Heston-SLV
+// (Euler tronqué, dS/S = r dt + L(t, S) sqrt(v) dW) jusqu'à p.T, pas de leverage.dt.
+void simulate_slv_block(const HestonParams& p, const LeverageFunction& leverage,
+                        std::uint64_t seed, long first_path, long n, double* S, double* v);
+
+// Monte Carlo sous Heston-SLV, payoff(S_T); mêmes blocs et même réduction que
+// heston_mc_parallel. Espérance non actualisée.
+template <typename Payoff>
+MonteCarloResult heston_slv_mc(const HestonParams& p, const LeverageFunction& leverage, long M,
+                               const Payoff& payoff, std::uint64_t seed, int threads = 0,
+                               long block_size = 2048) {
+    const long blocks = (M + block_size - 1) / block_size;
+    std::vector<RunningStats> block_stats(blocks);
+    parallel_for(0, blocks, threads, [&](long lo, long hi) {
+        std::vector<double> S(block_size), v(block_size);
+        for (long b = lo; b < hi; ++b) {
+            const long first = b * block_size;
+            const long n = std::min(block_size, M - first);
+            simulate_slv_block(p, leverage, seed, first, n, S.data(), v.data());
+            for (long m = 0; m < n; ++m) {
+                block_stats[b].add(payoff(S[m]));
+            }
+        }
+    });
+    RunningStats total;
+    for (const RunningStats& s : block_stats) {
+        total.merge(s);
+    }
+    return make_result(total);
+}
+
+#endif // SLV_H
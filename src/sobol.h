@@ -0,0 +1,37 @@
+#ifndef SOBOL_H
+#define SOBOL_H
+
+#include <cstdint>
+#include <vector>
+
+// Suite de Sobol en base 2 sur 32 bits, nombres directeurs de Joe et Kuo (2008,
+// new-joe-kuo-6.21201) pour les MAX_DIMENSION premières coordonnées.
+// Brouillage optionnel: matrice linéaire aléatoire triangulaire inférieure (Matoušek) suivie
+// d'un décalage digital, tirés de Philox à partir de (graine, réplique). Chaque réplique
+// brouillée est une suite (t, s) indépendante et sans biais.
+class SobolSequence {
+public:
+    static constexpr int MAX_DIMENSION = 256;
+    static constexpr int BITS = 32;
+
+    // Suite non brouillée.
+    explicit SobolSequence(int dimension);
+    // Suite brouillée pour la réplique replicate.
+    SobolSequence(int dimension, std::uint64_t seed, std::uint32_t replicate);
+
+    int dimension() const { return dimension_; }
+
+    // Points d'indices [first, first + n) dans l'ordre de Gray, écrits par point:
+    // u[k * dimension() + j] dans (0, 1).
+    void generate(std::uint64_t first, long n, double* u) const;
+
+private:
+    void scramble(std::uint64_t seed, std::uint32_t replicate);
+
+    int dimension_;
+    // direction_[j * BITS + b]: b-ième nombre directeur de la coordonnée j.
+    std::vector<std::uint32_t> direction_;
+    std::vector<std::uint32_t> shift_;
+};
+
+#endif // SOBOL_H
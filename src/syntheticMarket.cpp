@@ -0,0 +1,139 @@
+#include "syntheticMarket.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include "parallel.h"
+#include "pathSet.h"
+#include "philox.h"
+#include "pricer.h"
+
+using namespace std;
+
+namespace {
+
+double uniform_in(PhiloxStream& rng, double lo, double hi) {
+    return lo + (hi - lo) * rng.uniform();
+}
+
+// Jours depuis le 1970-01-01 <-> date civile (algorithmes de H. Hinnant).
+long days_from_civil(int y, int m, int d) {
+    y -= m <= 2;
+    const long era = (y >= 0 ? y : y - 399) / 400;
+    const long yoe = y - era * 400;
+    const long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+string civil_from_days(long z) {
+    z += 719468;
+    const long era = (z >= 0 ? z : z - 146096) / 146097;
+    const long doe = z - era * 146097;
+    const long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const long mp = (5 * doy + 2) / 153;
+    const int d = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    const int m = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    const long y = yoe + era * 400 + (m <= 2);
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%04ld-%02d-%02d", y, m, d);
+    return buffer;
+}
+
+}  // namespace
+
+HestonParams synthetic_params(uint64_t seed, long index, bool feller) {
+    PhiloxStream rng(seed, static_cast<uint64_t>(index), STREAM_SYNTHETIC_PARAMS);
+    HestonParams p;
+    p.S0 = uniform_in(rng, 20, 500);
+    p.drift = uniform_in(rng, 0.0, 0.05);
+    p.kappa = uniform_in(rng, 0.5, 4.0);
+    p.theta = uniform_in(rng, 0.02, 0.10);
+    p.sigma = uniform_in(rng, 0.2, 0.8);
+    p.rho = uniform_in(rng, -0.9, -0.3);
+    p.v0 = p.theta * uniform_in(rng, 0.5, 1.5);
+    if (feller) {
+        p.sigma = min(p.sigma, 0.95 * sqrt(2 * p.kappa * p.theta));
+    }
+    p.T = 0;  // fixé par la longueur de l'historique
+    return p;
+}
+
+vector<string> business_days(const string& start, int count) {
+    int y, m, d;
+    if (sscanf(start.c_str(), "%d-%d-%d", &y, &m, &d) != 3) {
+        throw invalid_argument("start date must be YYYY-MM-DD");
+    }
+    vector<string> days;
+    days.reserve(count);
+    for (long z = days_from_civil(y, m, d); static_cast<int>(days.size()) < count; ++z) {
+        const long weekday = ((z % 7) + 10) % 7;  // 0 = lundi (le 1970-01-01 est un jeudi)
+        if (weekday < 5) {
+            days.push_back(civil_from_days(z));
+        }
+    }
+    return days;
+}
+
+vector<SyntheticSymbol> generate_synthetic_market(const SyntheticMarketConfig& config) {
+    if (config.days <= 0 || config.symbols <= 0) {
+        throw invalid_argument("symbols and days must be positive");
+    }
+    const vector<string> dates = business_days(config.start_date, config.days + 1);
+    vector<SyntheticSymbol> market(config.symbols);
+
+    parallel_for(0, config.symbols, config.threads, [&](long lo, long hi) {
+        PathSet path(config.days, 1);
+        for (long s = lo; s < hi; ++s) {
+            SyntheticSymbol& out = market[s];
+            char name[16];
+            snprintf(name, sizeof(name), "SYN%05ld", s);
+            out.symbol = name;
+            out.params = synthetic_params(config.seed, s, config.feller);
+            out.params.T = config.days / 252.0;
+
+            // Historique: la trajectoire s du moteur par blocs, un pas par jour ouvré.
+            simulate_paths_block(out.params, config.days, config.seed, s, 1, path.stock(0),
+                                 path.variance(0), path.stride());
+            out.bars.resize(config.days + 1);
+            out.variance.resize(config.days + 1);
+            for (int i = 0; i <= config.days; ++i) {
+                out.bars[i] = {dates[i], path.stock(i)[0]};
+                out.variance[i] = path.variance(i)[0];
+            }
+
+            // Chaîne d'options hors de la monnaie au dernier état (S, v).
+            const double S = path.stock(config.days)[0];
+            const double v = max(path.variance(config.days)[0], 1e-6);
+            // Quadrature à erreur contrôlée (un dixième du bruit), là où la règle à pas fixe
+            // de HestonBatchPricer n'offre pas de borne d'erreur.
+            const HestonParams& p = out.params;
+            const double tolerance = 0.1 * config.absolute_noise;
+            vector<BatchContract> contracts;
+            vector<double> prices;
+            for (double tau : config.maturities) {
+                const double forward = S * exp(p.drift * tau);
+                for (double k : config.moneyness) {
+                    const double K = k * forward;
+                    const bool is_call = K >= forward;
+                    HestonPricer pricer(S, K, tau, v, p.kappa, p.theta, p.sigma, p.rho, p.drift);
+                    const auto deadline = chrono::steady_clock::time_point::max();
+                    const PricingEstimate e = is_call
+                                                  ? pricer.price_call_within(deadline, tolerance)
+                                                  : pricer.price_put_within(deadline, tolerance);
+                    contracts.push_back({K, tau, is_call});
+                    prices.push_back(max(0.0, e.price));
+                }
+            }
+            PhiloxStream rng(config.seed, static_cast<uint64_t>(s), STREAM_SYNTHETIC_NOISE);
+            out.chain.resize(contracts.size());
+            for (size_t c = 0; c < contracts.size(); ++c) {
+                const double sd = config.relative_noise * prices[c] + config.absolute_noise;
+                out.chain[c] = {contracts[c], prices[c], max(0.0, prices[c] + sd * rng.normal())};
+            }
+        }
+    });
+    return market;
+}
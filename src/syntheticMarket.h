@@ -0,0 +1,53 @@
+#ifndef SYNTHETIC_MARKET_H
+#define SYNTHETIC_MARKET_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "batchPricer.h"
+#include "fetchData.h"
+#include "monteCarlo.h"
+
+// Marché synthétique à paramètres connus, pour mesurer la calibration hors ligne et de
+// façon reproductible (sans Alpha Vantage).
+struct SyntheticMarketConfig {
+    int symbols = 1000;
+    int days = 504;                          // jours ouvrés d'historique, dt = 1/252
+    std::string start_date = "2023-01-02";   // premier jour (AAAA-MM-JJ), week-ends sautés
+    std::vector<double> maturities = {1.0 / 12, 0.25, 0.5, 1.0};
+    std::vector<double> moneyness = {0.8, 0.85, 0.9, 0.95, 1.0, 1.05, 1.1, 1.15, 1.2};
+    double relative_noise = 0.01;            // écart type du bruit de prix, relatif...
+    double absolute_noise = 0.005;           // ... plus un plancher absolu (tick)
+    bool feller = true;                      // paramètres vérifiant 2 kappa theta > sigma^2
+    std::uint64_t seed = 42;
+    int threads = 0;
+};
+
+struct SyntheticQuote {
+    BatchContract contract;  // options hors de la monnaie: puts sous le forward, calls au-dessus
+    double model_price;      // prix de Heston exact aux paramètres vrais
+    double price;            // prix bruité observé
+};
+
+struct SyntheticSymbol {
+    std::string symbol;
+    HestonParams params;           // paramètres vrais; drift = taux sans risque
+    std::vector<DailyBar> bars;    // days + 1 clôtures (format de fetch_alpha_vantage_*)
+    std::vector<double> variance;  // variance instantanée aux mêmes dates
+    std::vector<SyntheticQuote> chain;  // cotée au dernier jour (S, v finaux)
+};
+
+// Paramètres vrais du symbole index, tirés uniformément dans des plages réalistes à partir
+// de (graine, index): reproductibles et indépendants de l'ordre de génération.
+HestonParams synthetic_params(std::uint64_t seed, long index, bool feller);
+
+// Jours ouvrés successifs (lundi-vendredi) à partir de start (AAAA-MM-JJ), start compris
+// s'il est ouvré.
+std::vector<std::string> business_days(const std::string& start, int count);
+
+// Génère config.symbols symboles en parallèle. Historique: une trajectoire d'Euler tronqué
+// de days pas quotidiens (le schéma de HestonSimulation, tirages Philox indexés par le
+// symbole). Chaîne: prix de Fourier au dernier état, bruit gaussien Philox.
+std::vector<SyntheticSymbol> generate_synthetic_market(const SyntheticMarketConfig& config);
+
+#endif // SYNTHETIC_MARKET_H
@@ -0,0 +1,41 @@
+#include "varianceReduction.h"
+#include <chrono>
+#include <cmath>
+#include "pricer.h"
+
+using namespace std;
+
+double control_expectation(const HestonParams& p, double K) {
+    HestonPricer pricer(p.S0, K, p.T, p.v0, p.kappa, p.theta, p.sigma, p.rho, p.drift);
+    // La quadrature adaptative est plus précise que price_call (règle des rectangles): son
+    // erreur se reporterait telle quelle sur l'estimateur contrôlé.
+    double price = pricer.price_call_within(chrono::steady_clock::time_point::max(), 1e-10).price;
+    return exp(p.drift * p.T) * price;
+}
+
+VarianceReductionResult finish_variance_reduction(const RunningCovariance& xy,
+                                                  const RunningStats& single,
+                                                  double control_mean, bool control_variate) {
+    const long n = xy.count();
+    const double var_x = xy.variance_x(), var_y = xy.variance_y(), cov = xy.covariance();
+    double beta = 0.0, correlation = 0.0;
+    if (var_x > 0 && var_y > 0) {
+        correlation = cov / sqrt(var_x * var_y);
+        if (control_variate) {
+            beta = cov / var_y;
+        }
+    }
+    const double estimate = xy.mean_x() - beta * (xy.mean_y() - control_mean);
+    const double var_sample = max(0.0, var_x - 2 * beta * cov + beta * beta * var_y);
+    const double std_error = n > 0 ? sqrt(var_sample / n) : 0.0;
+    const double h = 1.96 * std_error;
+
+    VarianceReductionResult out;
+    out.result = {estimate, std_error, estimate - h, estimate + h, single.count()};
+    out.beta = beta;
+    out.correlation = correlation;
+    // MC simple sur le même nombre de trajectoires: Var(X) / single.count().
+    const double plain = single.count() > 0 ? single.variance() / single.count() : 0.0;
+    out.variance_reduction = std_error > 0 ? plain / (std_error * std_error) : 0.0;
+    return out;
+}
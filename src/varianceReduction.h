@@ -0,0 +1,152 @@
+#ifndef VARIANCE_REDUCTION_H
+#define VARIANCE_REDUCTION_H
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "monteCarlo.h"
+#include "parallel.h"
+#include "payoffs.h"
+#include "runningStats.h"
+
+struct VarianceReduction {
+    bool antithetic = true;
+    bool control_variate = true;
+    // Variable de contrôle: call européen (S_T - control_strike)^+, d'espérance connue par
+    // HestonPricer. control_strike <= 0: strike à la monnaie (S0).
+    double control_strike = 0.0;
+    Scheme scheme = Scheme::Euler;
+};
+
+struct VarianceReductionResult {
+    MonteCarloResult result;
+    double beta;                // coefficient de contrôle estimé (0 sans contrôle)
+    double correlation;         // corrélation payoff / contrôle sur les échantillons
+    double variance_reduction;  // Var(MC simple) / Var(estimateur) à trajectoires égales
+};
+
+// Espérance non actualisée du contrôle, E[(S_T - K)^+] = e^{rT} * prix Fourier.
+double control_expectation(const HestonParams& p, double K);
+
+// Assemble l'estimateur à partir des statistiques réduites: xy porte (payoff, contrôle) par
+// échantillon (moyenne d'une paire en antithétique), single les payoffs trajectoire par
+// trajectoire (référence du MC simple). Sans contrôle, beta = 0.
+VarianceReductionResult finish_variance_reduction(const RunningCovariance& xy,
+                                                  const RunningStats& single,
+                                                  double control_mean, bool control_variate);
+
+// Monte Carlo à variance réduite pour un payoff terminal payoff(S_T): paires antithétiques
+// (M trajectoires = M / 2 paires) et/ou variable de contrôle au coefficient optimal
+// beta = Cov(X, Y) / Var(Y), estimé sur les statistiques accumulées en ligne par bloc. Le
+// contrôle est simulé avec le même schéma que le payoff, ce qui compense aussi une partie
+// du biais de discrétisation. Résultat identique quel que soit le nombre de threads.
+template <typename Payoff>
+VarianceReductionResult heston_mc_reduced(const HestonParams& p, int N, long M,
+                                          const Payoff& payoff, std::uint64_t seed,
+                                          const VarianceReduction& options = VarianceReduction(),
+                                          int threads = 0, long block_size = 2048) {
+    const bool antithetic = options.antithetic;
+    const double Kc = options.control_strike > 0 ? options.control_strike : p.S0;
+    const long samples = antithetic ? (M + 1) / 2 : M;
+    const long blocks = (samples + block_size - 1) / block_size;
+    std::vector<RunningCovariance> block_xy(blocks);
+    std::vector<RunningStats> block_single(blocks);
+
+    parallel_for(0, blocks, threads, [&](long lo, long hi) {
+        std::vector<double> S(2 * block_size), v(2 * block_size);
+        for (long b = lo; b < hi; ++b) {
+            const long first = b * block_size;
+            const long n = std::min(block_size, samples - first);
+            if (antithetic) {
+                simulate_antithetic_block(p, N, seed, first, n, S.data(), v.data(),
+                                          options.scheme);
+            } else {
+                simulate_block(p, N, seed, first, n, S.data(), v.data(), options.scheme);
+            }
+            for (long k = 0; k < n; ++k) {
+                double x = payoff(S[k]);
+                double y = std::max(S[k] - Kc, 0.0);
+                block_single[b].add(x);
+                if (antithetic) {
+                    double x_bar = payoff(S[n + k]);
+                    double y_bar = std::max(S[n + k] - Kc, 0.0);
+                    block_single[b].add(x_bar);
+                    x = 0.5 * (x + x_bar);
+                    y = 0.5 * (y + y_bar);
+                }
+                block_xy[b].add(x, y);
+            }
+        }
+    });
+
+    RunningCovariance xy;
+    RunningStats single;
+    for (long b = 0; b < blocks; ++b) {
+        xy.merge(block_xy[b]);
+        single.merge(block_single[b]);
+    }
+    const double control_mean = options.control_variate ? control_expectation(p, Kc) : 0.0;
+    return finish_variance_reduction(xy, single, control_mean, options.control_variate);
+}
+
+// Même estimateur pour un payoff dépendant du chemin, donné par une politique de payoffs.h
+// (start / observe / value) évaluée pendant la propagation. Le contrôle reste le call
+// européen sur le S_T de la même trajectoire, accumulé avec le payoff dans le même
+// RunningCovariance: pour une asiatique ou une barrière, la corrélation vient du chemin
+// commun et non d'une identité de payoff.
+template <typename Payoff>
+VarianceReductionResult heston_mc_reduced_path(const HestonParams& p, int N, long M,
+                                               const Payoff& payoff, std::uint64_t seed,
+                                               const VarianceReduction& options =
+                                                   VarianceReduction(),
+                                               int threads = 0, long block_size = 2048) {
+    static_assert(std::is_copy_constructible<Payoff>::value,
+                  "payoff policies are copied once per thread");
+    const bool antithetic = options.antithetic;
+    const double Kc = options.control_strike > 0 ? options.control_strike : p.S0;
+    const long samples = antithetic ? (M + 1) / 2 : M;
+    const long blocks = (samples + block_size - 1) / block_size;
+    std::vector<RunningCovariance> block_xy(blocks);
+    std::vector<RunningStats> block_single(blocks);
+
+    parallel_for(0, blocks, threads, [&](long lo, long hi) {
+        Payoff local = payoff;
+        std::vector<double> S(2 * block_size), v(2 * block_size);
+        for (long b = lo; b < hi; ++b) {
+            const long first = b * block_size;
+            const long n = std::min(block_size, samples - first);
+            if (antithetic) {
+                simulate_antithetic_payoff_block(p, N, seed, first, n, S.data(), v.data(),
+                                                 options.scheme, local);
+            } else {
+                simulate_payoff_block(p, N, seed, first, n, S.data(), v.data(), options.scheme,
+                                      local);
+            }
+            for (long k = 0; k < n; ++k) {
+                double x = local.value(k);
+                double y = std::max(S[k] - Kc, 0.0);
+                block_single[b].add(x);
+                if (antithetic) {
+                    double x_bar = local.value(n + k);
+                    double y_bar = std::max(S[n + k] - Kc, 0.0);
+                    block_single[b].add(x_bar);
+                    x = 0.5 * (x + x_bar);
+                    y = 0.5 * (y + y_bar);
+                }
+                block_xy[b].add(x, y);
+            }
+        }
+    });
+
+    RunningCovariance xy;
+    RunningStats single;
+    for (long b = 0; b < blocks; ++b) {
+        xy.merge(block_xy[b]);
+        single.merge(block_single[b]);
+    }
+    const double control_mean = options.control_variate ? control_expectation(p, Kc) : 0.0;
+    return finish_variance_reduction(xy, single, control_mean, options.control_variate);
+}
+
+#endif // VARIANCE_REDUCTION_H